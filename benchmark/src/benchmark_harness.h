@@ -0,0 +1,199 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace circular_lifo_buffer
+{
+namespace benchmark
+{
+/**
+ * Result of a single benchmark case. Each case reports a set of named metrics, which are written as one JSON object.
+ */
+struct Result
+{
+  Result(const std::string& case_name, const std::string& buffer_name, const std::string& api_name, size_t case_payload_size,
+         uint64_t case_iterations = 0)
+    : name(case_name), buffer(buffer_name), api(api_name), payload_size(case_payload_size), iterations(case_iterations)
+  {
+  }
+
+  std::string name;
+  std::string buffer;
+  std::string api;
+  size_t payload_size;
+  uint64_t iterations;
+  std::vector<std::pair<std::string, double>> metrics;
+
+  void addMetric(const std::string& metric_name, double value) { metrics.emplace_back(metric_name, value); }
+};
+
+/**
+ * Settings given on the command line, which are passed to every benchmark case.
+ */
+struct Settings
+{
+  /** minimum duration each case is measured */
+  std::chrono::milliseconds min_time{ 200 };
+  /** only cases whose name contains this string are run */
+  std::string filter;
+};
+
+using BenchmarkFunction = std::function<void(const Settings&, std::vector<Result>&)>;
+
+/**
+ * Registry of all benchmark cases, which are added by BENCHMARK_CASE before main() is entered.
+ */
+class Registry
+{
+public:
+  static Registry& instance()
+  {
+    static Registry registry;
+    return registry;
+  }
+
+  bool add(const std::string& name, BenchmarkFunction function)
+  {
+    cases_.emplace_back(name, std::move(function));
+    return true;
+  }
+
+  const std::vector<std::pair<std::string, BenchmarkFunction>>& cases() const { return cases_; }
+
+private:
+  std::vector<std::pair<std::string, BenchmarkFunction>> cases_;
+};
+
+/**
+ * Defines and registers a benchmark case. The body has access to the Settings as settings and appends its results to
+ * results.
+ */
+#define BENCHMARK_CASE(case_name)                                                                                                 \
+  static void benchmark_##case_name(const ::circular_lifo_buffer::benchmark::Settings& settings,                                 \
+                                    std::vector<::circular_lifo_buffer::benchmark::Result>& results);                            \
+  static const bool benchmark_##case_name##_registered = ::circular_lifo_buffer::benchmark::Registry::instance().add(#case_name, \
+                                                                                                                      benchmark_##case_name); \
+  static void benchmark_##case_name(const ::circular_lifo_buffer::benchmark::Settings& settings,                                 \
+                                    std::vector<::circular_lifo_buffer::benchmark::Result>& results)
+
+/**
+ * Prevents the compiler from optimizing away the computation of the given value.
+ */
+template <class T>
+inline void doNotOptimize(const T& value)
+{
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/**
+ * Calls the given function with a growing number of iterations until the measurement takes at least the minimum time
+ * and returns the duration of a single iteration in nanoseconds.
+ */
+template <class Function>
+double measureNsPerIteration(const Settings& settings, Function&& run_iterations, uint64_t& iterations)
+{
+  iterations = 1;
+  while (true)
+  {
+    const auto start_time = std::chrono::steady_clock::now();
+    run_iterations(iterations);
+    const auto duration = std::chrono::steady_clock::now() - start_time;
+    if (duration >= settings.min_time || iterations >= (uint64_t(1) << 40))
+    {
+      return std::chrono::duration<double, std::nano>(duration).count() / iterations;
+    }
+    iterations *= 2;
+  }
+}
+
+/**
+ * Returns the value at the given quantile of the samples, which are sorted by this function.
+ */
+inline double quantile(std::vector<double>& samples, double q)
+{
+  if (samples.empty())
+  {
+    return 0.0;
+  }
+  std::sort(samples.begin(), samples.end());
+  return samples[std::min(samples.size() - 1, size_t(q * samples.size()))];
+}
+
+/**
+ * Pins the calling thread to the given CPU, if the system has enough CPUs. Cross-core measurements are only meaningful
+ * if the threads are pinned to different cores.
+ * @return true if the thread was pinned
+ */
+inline bool pinToCpu(unsigned cpu)
+{
+#ifdef __linux__
+  if (cpu >= std::thread::hardware_concurrency())
+  {
+    return false;
+  }
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  CPU_SET(cpu, &cpu_set);
+  return pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set) == 0;
+#else
+  (void)cpu;
+  return false;
+#endif
+}
+
+/**
+ * Writes the results as JSON object containing the context of the run and the list of results.
+ */
+inline void writeJson(std::ostream& output, const std::vector<Result>& results)
+{
+  const auto escape = [](const std::string& text) {
+    std::string escaped;
+    for (char character : text)
+    {
+      if (character == '"' || character == '\\')
+      {
+        escaped += '\\';
+      }
+      escaped += character;
+    }
+    return escaped;
+  };
+
+  output.precision(10);
+  output << "{\n  \"context\": {\n";
+  output << "    \"timestamp\": "
+         << std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count() << ",\n";
+  output << "    \"hardware_concurrency\": " << std::thread::hardware_concurrency() << ",\n";
+  output << "    \"compiler\": \"" << escape(__VERSION__) << "\"\n";
+  output << "  },\n  \"benchmarks\": [";
+  for (size_t i = 0; i < results.size(); i++)
+  {
+    const Result& result = results[i];
+    output << (i == 0 ? "\n" : ",\n");
+    output << "    {\"name\": \"" << escape(result.name) << "\", \"buffer\": \"" << escape(result.buffer) << "\", \"api\": \""
+           << escape(result.api) << "\", \"payload_size\": " << result.payload_size << ", \"iterations\": " << result.iterations;
+    for (const auto& metric : result.metrics)
+    {
+      output << ", \"" << escape(metric.first) << "\": " << metric.second;
+    }
+    output << "}";
+  }
+  output << "\n  ]\n}\n";
+}
+}  // namespace benchmark
+}  // namespace circular_lifo_buffer
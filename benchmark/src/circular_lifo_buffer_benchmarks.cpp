@@ -0,0 +1,347 @@
+#include <string.h>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "benchmark_harness.h"
+#include "circular_lifo_buffer/circular_lifo_buffer.h"
+
+namespace circular_lifo_buffer
+{
+namespace benchmark
+{
+namespace
+{
+/* pairs of configurations that only differ in the layout, so the effect of isolating the cache lines is measured */
+struct TripleBufferPackedTraits : DefaultBufferTraits
+{
+  using Strategy = TripleBufferStrategy;
+};
+
+struct TripleBufferIsolatedTraits : TripleBufferPackedTraits
+{
+  using Layout = CacheLineIsolatedLayout;
+};
+
+struct WaitFreePackedTraits : TripleBufferPackedTraits
+{
+  using IndexProtocol = WaitFreeProtocol;
+};
+
+struct WaitFreeIsolatedTraits : WaitFreePackedTraits
+{
+  using Layout = CacheLineIsolatedLayout;
+};
+
+struct WaitFreeAcquireReleaseIsolatedTraits : DefaultBufferTraits
+{
+  using Strategy = TripleBufferStrategy;
+  using IndexProtocol = WaitFreeProtocol;
+  using Layout = CacheLineIsolatedLayout;
+  using MemoryOrdering = AcquireReleaseOrdering;
+};
+
+/* records the publish time of each element, so the reader can measure the age of the data */
+template <class Traits>
+struct WithPublishTimestamps : Traits
+{
+  using PublishTimestamps = SteadyClockPublishTimestamps;
+};
+
+/* Element of the given size in bytes, which is either copied as a whole or only stamped in place */
+template <size_t SIZE>
+struct Payload
+{
+  uint8_t bytes[SIZE];
+};
+
+/* payload sizes from 4 B to 16 MB */
+template <class Function>
+void forEachPayloadSize(Function&& function)
+{
+  function(std::integral_constant<size_t, 4>{});
+  function(std::integral_constant<size_t, 64>{});
+  function(std::integral_constant<size_t, 1024>{});
+  function(std::integral_constant<size_t, 16 * 1024>{});
+  function(std::integral_constant<size_t, 256 * 1024>{});
+  function(std::integral_constant<size_t, 4 * 1024 * 1024>{});
+  function(std::integral_constant<size_t, 16 * 1024 * 1024>{});
+}
+
+/* runs the function for each buffer configuration compared by the benchmarks */
+template <class Function>
+void forEachBufferConfiguration(Function&& function)
+{
+  function(DefaultBufferTraits{}, "default");
+  function(TripleBufferPackedTraits{}, "triple_buffer_packed");
+  function(TripleBufferIsolatedTraits{}, "triple_buffer_isolated");
+  function(WaitFreePackedTraits{}, "wait_free_packed");
+  function(WaitFreeIsolatedTraits{}, "wait_free_isolated");
+  function(WaitFreeAcquireReleaseIsolatedTraits{}, "wait_free_acquire_release_isolated");
+}
+
+/* the buffer and the payloads are allocated on the heap, as they may be too large for the stack */
+template <class Element, class Traits>
+std::unique_ptr<CircularLifoBuffer<Element, Traits>> makeBuffer()
+{
+  auto buffer = std::make_unique<CircularLifoBuffer<Element, Traits>>();
+  /* touches all elements, so no page faults are measured */
+  buffer->setupBufferElements([](Element& element) { memset(&element, 0, sizeof(Element)); });
+  return buffer;
+}
+
+template <class Element>
+std::unique_ptr<Element> makePayload()
+{
+  auto payload = std::make_unique<Element>();
+  memset(payload.get(), 1, sizeof(Element));
+  return payload;
+}
+
+/* writes the element through the copy API or stamps it in place through the pointer API */
+template <class Buffer, class Element>
+void write(Buffer& buffer, const Element& source, bool use_copy_api, uint8_t stamp)
+{
+  if (use_copy_api)
+  {
+    buffer.push(source);
+  }
+  else
+  {
+    Element* const write_ptr = buffer.getWriteAccessPtr();
+    write_ptr->bytes[0] = stamp;
+    buffer.indicateWriteDone();
+  }
+}
+
+/* reads the element through the copy API or in place through the pointer API */
+template <class Buffer, class Element>
+bool read(Buffer& buffer, Element& target, bool use_copy_api)
+{
+  if (use_copy_api)
+  {
+    const bool has_new_data = buffer.popIfNew(target);
+    doNotOptimize(target.bytes[0]);
+    return has_new_data;
+  }
+  bool has_new_data;
+  const Element* const read_ptr = buffer.getNewReadAccessPtr(has_new_data);
+  doNotOptimize(read_ptr->bytes[0]);
+  return has_new_data;
+}
+
+const char* apiName(bool use_copy_api) { return use_copy_api ? "copy" : "pointer"; }
+
+/* waits actively for the deadline, as sleeping is too coarse for periods of a few microseconds */
+void waitUntil(std::chrono::steady_clock::time_point deadline)
+{
+  while (std::chrono::steady_clock::now() < deadline)
+  {
+    std::this_thread::yield();
+  }
+}
+
+double toNs(std::chrono::nanoseconds duration) { return double(duration.count()); }
+}  // namespace
+
+/* cost of one push followed by one extraction within the same thread */
+BENCHMARK_CASE(PushPop)
+{
+  forEachBufferConfiguration([&](auto traits, const char* buffer_name) {
+    forEachPayloadSize([&](auto size) {
+      using Element = Payload<decltype(size)::value>;
+      for (bool use_copy_api : { true, false })
+      {
+        auto buffer = makeBuffer<Element, decltype(traits)>();
+        auto source = makePayload<Element>();
+        auto target = makePayload<Element>();
+
+        Result result{ "PushPop", buffer_name, apiName(use_copy_api), sizeof(Element) };
+        const double ns_per_iteration = measureNsPerIteration(
+            settings,
+            [&](uint64_t iterations) {
+              for (uint64_t i = 0; i < iterations; i++)
+              {
+                write(*buffer, *source, use_copy_api, uint8_t(i));
+                read(*buffer, *target, use_copy_api);
+              }
+            },
+            result.iterations);
+        result.addMetric("ns_per_push_pop", ns_per_iteration);
+        results.push_back(result);
+      }
+    });
+  });
+}
+
+/* one-way latency between two threads pinned to different cores, measured by round trips through two buffers */
+BENCHMARK_CASE(PingPong)
+{
+  forEachBufferConfiguration([&](auto traits, const char* buffer_name) {
+    forEachPayloadSize([&](auto size) {
+      using Element = Payload<decltype(size)::value>;
+      for (bool use_copy_api : { true, false })
+      {
+        auto request_buffer = makeBuffer<Element, decltype(traits)>();
+        auto response_buffer = makeBuffer<Element, decltype(traits)>();
+        std::atomic<bool> stop{ false };
+
+        std::thread responder([&]() {
+          pinToCpu(1);
+          auto message = makePayload<Element>();
+          while (!stop.load(std::memory_order_relaxed))
+          {
+            if (read(*request_buffer, *message, use_copy_api))
+            {
+              write(*response_buffer, *message, use_copy_api, 0);
+            }
+          }
+        });
+
+        pinToCpu(0);
+        auto message = makePayload<Element>();
+        std::vector<double> samples;
+        const auto start_time = std::chrono::steady_clock::now();
+        while (std::chrono::steady_clock::now() - start_time < settings.min_time || samples.size() < 10)
+        {
+          const auto send_time = std::chrono::steady_clock::now();
+          write(*request_buffer, *message, use_copy_api, 0);
+          while (!read(*response_buffer, *message, use_copy_api))
+          {
+          }
+          samples.push_back(std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - send_time).count() / 2);
+        }
+        stop = true;
+        responder.join();
+
+        Result result{ "PingPong", buffer_name, apiName(use_copy_api), sizeof(Element), samples.size() };
+        result.addMetric("one_way_latency_ns_p50", quantile(samples, 0.5));
+        result.addMetric("one_way_latency_ns_p99", quantile(samples, 0.99));
+        result.addMetric("one_way_latency_ns_max", quantile(samples, 1.0));
+        results.push_back(result);
+      }
+    });
+  });
+}
+
+/* sustained rate of a writer pushing as fast as possible while a reader on another core extracts concurrently */
+BENCHMARK_CASE(Throughput)
+{
+  forEachBufferConfiguration([&](auto traits, const char* buffer_name) {
+    forEachPayloadSize([&](auto size) {
+      using Element = Payload<decltype(size)::value>;
+      for (bool use_copy_api : { true, false })
+      {
+        auto buffer = makeBuffer<Element, decltype(traits)>();
+        std::atomic<bool> stop{ false };
+        uint64_t nr_of_reads = 0;
+
+        std::thread reader([&]() {
+          pinToCpu(1);
+          auto target = makePayload<Element>();
+          while (!stop.load(std::memory_order_relaxed))
+          {
+            nr_of_reads += read(*buffer, *target, use_copy_api) ? 1 : 0;
+          }
+        });
+
+        pinToCpu(0);
+        auto source = makePayload<Element>();
+        uint64_t nr_of_writes = 0;
+        const auto start_time = std::chrono::steady_clock::now();
+        auto duration = std::chrono::steady_clock::duration::zero();
+        while (duration < settings.min_time)
+        {
+          for (int i = 0; i < 16; i++)
+          {
+            write(*buffer, *source, use_copy_api, uint8_t(nr_of_writes++));
+          }
+          duration = std::chrono::steady_clock::now() - start_time;
+        }
+        stop = true;
+        reader.join();
+
+        const double seconds = std::chrono::duration<double>(duration).count();
+        Result result{ "Throughput", buffer_name, apiName(use_copy_api), sizeof(Element), nr_of_writes };
+        result.addMetric("writes_per_second", nr_of_writes / seconds);
+        result.addMetric("reads_per_second", nr_of_reads / seconds);
+        if (use_copy_api)
+        {
+          /* the pointer API only stamps the elements, so no bytes are copied */
+          result.addMetric("copied_bytes_per_second", nr_of_writes * double(sizeof(Element)) / seconds);
+        }
+        results.push_back(result);
+      }
+    });
+  });
+}
+
+/* age of the data when the reader uses it and delay until a published element is seen by the reader, for a periodic
+ * reader and a periodic writer running at different rates */
+BENCHMARK_CASE(Freshness)
+{
+  constexpr std::chrono::microseconds READ_PERIOD{ 100 };
+  forEachBufferConfiguration([&](auto traits, const char* buffer_name) {
+    using Element = Payload<64>;
+    /* rate of the writer relative to the one of the reader */
+    for (double rate_ratio : { 0.5, 1.0, 2.0, 10.0 })
+    {
+      auto buffer = makeBuffer<Element, WithPublishTimestamps<decltype(traits)>>();
+      const auto write_period = std::chrono::duration_cast<std::chrono::nanoseconds>(READ_PERIOD / rate_ratio);
+      std::atomic<bool> stop{ false };
+
+      std::thread writer([&]() {
+        pinToCpu(1);
+        auto source = makePayload<Element>();
+        auto next_write_time = std::chrono::steady_clock::now();
+        for (uint8_t stamp = 0; !stop.load(std::memory_order_relaxed); stamp++)
+        {
+          next_write_time += write_period;
+          waitUntil(next_write_time);
+          write(*buffer, *source, false, stamp);
+        }
+      });
+
+      pinToCpu(0);
+      auto target = makePayload<Element>();
+      std::vector<double> ages;
+      std::vector<double> visibility_delays;
+      uint64_t nr_of_skipped_elements = 0;
+      const auto start_time = std::chrono::steady_clock::now();
+      auto next_read_time = start_time;
+      while (std::chrono::steady_clock::now() - start_time < settings.min_time || ages.size() < 10)
+      {
+        next_read_time += READ_PERIOD;
+        waitUntil(next_read_time);
+        if (read(*buffer, *target, false))
+        {
+          visibility_delays.push_back(toNs(buffer->getVisibilityDelay()));
+          nr_of_skipped_elements += buffer->getNrOfSkippedElements();
+        }
+        if (buffer->getLastReadSequenceNumber() > 0)
+        {
+          ages.push_back(toNs(buffer->age()));
+        }
+      }
+      stop = true;
+      writer.join();
+
+      Result result{ "Freshness", buffer_name, apiName(false), sizeof(Element), ages.size() };
+      result.addMetric("writer_reader_rate_ratio", rate_ratio);
+      result.addMetric("age_at_use_ns_p50", quantile(ages, 0.5));
+      result.addMetric("age_at_use_ns_p99", quantile(ages, 0.99));
+      result.addMetric("age_at_use_ns_max", quantile(ages, 1.0));
+      result.addMetric("visibility_delay_ns_p50", quantile(visibility_delays, 0.5));
+      result.addMetric("visibility_delay_ns_p99", quantile(visibility_delays, 0.99));
+      result.addMetric("visibility_delay_ns_max", quantile(visibility_delays, 1.0));
+      result.addMetric("new_elements_per_read", visibility_delays.size() / double(ages.size()));
+      result.addMetric("skipped_elements_per_new_element",
+                       visibility_delays.empty() ? 0.0 : nr_of_skipped_elements / double(visibility_delays.size()));
+      results.push_back(result);
+    }
+  });
+}
+}  // namespace benchmark
+}  // namespace circular_lifo_buffer
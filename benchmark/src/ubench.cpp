@@ -0,0 +1,61 @@
+#include <stdlib.h>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "benchmark_harness.h"
+
+using circular_lifo_buffer::benchmark::Registry;
+using circular_lifo_buffer::benchmark::Result;
+using circular_lifo_buffer::benchmark::Settings;
+
+// Runs all the benchmarks that were declared with BENCHMARK_CASE() and writes the results as JSON
+int main(int argc, char** argv)
+{
+  Settings settings;
+  std::string output_file;
+  for (int i = 1; i < argc; i++)
+  {
+    const std::string argument = argv[i];
+    if (argument.rfind("--output=", 0) == 0)
+    {
+      output_file = argument.substr(9);
+    }
+    else if (argument.rfind("--filter=", 0) == 0)
+    {
+      settings.filter = argument.substr(9);
+    }
+    else if (argument.rfind("--min_time_ms=", 0) == 0)
+    {
+      settings.min_time = std::chrono::milliseconds(atol(argument.substr(14).c_str()));
+    }
+    else
+    {
+      std::cerr << "Usage: " << argv[0] << " [--output=<json file>] [--filter=<case name part>] [--min_time_ms=<duration per case>]" << std::endl;
+      return 1;
+    }
+  }
+
+  std::vector<Result> results;
+  for (const auto& benchmark_case : Registry::instance().cases())
+  {
+    if (benchmark_case.first.find(settings.filter) == std::string::npos)
+    {
+      continue;
+    }
+    std::cerr << "Running " << benchmark_case.first << std::endl;
+    benchmark_case.second(settings, results);
+  }
+
+  if (output_file.empty())
+  {
+    circular_lifo_buffer::benchmark::writeJson(std::cout, results);
+  }
+  else
+  {
+    std::ofstream output(output_file);
+    circular_lifo_buffer::benchmark::writeJson(output, results);
+  }
+  return 0;
+}
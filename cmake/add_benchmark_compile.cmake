@@ -0,0 +1,68 @@
+#
+# Adds option to generate the benchmark executable. In order to generate the
+# benchmarks, the CMake build flag ``BUILD_BENCHMARK`` must be set, e.g.
+# ``-DBUILD_BENCHMARK=ON``. The sources can be defined outside as well as given
+# as argument to the macro. It assumes that the main function is given in
+# benchmark/src/ubench.cpp, which can be altered using the ``BENCHMARK_MAIN``
+# argument and the project library is linked under ``${PROJECT_NAME}``. The
+# benchmarks are always compiled with optimizations, independent of the build
+# type.
+#
+# :param LINK_TARGET: Option to specify name of output executable (default ubench)
+# :type LINK_TARGET: string
+# :param BENCHMARK_MAIN: Option to specify ``CMAKE_CURRENT_SOURCE_DIR``-relative
+#   path to the benchmark main (default benchmark/src/ubench.cpp)
+# :type BENCHMARK_MAIN: string
+# :param SOURCES: Option to specify ``CMAKE_CURRENT_SOURCE_DIR``-relative
+#   source files
+# :type SOURCES: list of strings
+#
+# Example:
+# ::
+#
+#   set(BENCHMARK_SOURCES
+#     benchmark_case1.cpp
+#     ...
+#   )
+#
+#   add_benchmark_compile()
+#
+# @public
+#
+function(add_benchmark_compile)
+  cmake_parse_arguments(
+    BENCHMARK_COMPILE
+    ""
+    "LINK_TARGET;BENCHMARK_MAIN"
+    "SOURCES"
+    ${ARGN}
+  )
+
+  if(BUILD_BENCHMARK)
+    message(STATUS "Building Benchmarks Enabled")
+    find_package(Threads REQUIRED)
+
+    if(NOT DEFINED BENCHMARK_COMPILE_LINK_TARGET)
+      set(LINK_TARGET ubench)
+    else()
+      set(LINK_TARGET ${BENCHMARK_COMPILE_LINK_TARGET})
+    endif()
+
+    if(NOT DEFINED BENCHMARK_COMPILE_BENCHMARK_MAIN)
+      set(BENCHMARK_MAIN benchmark/src/ubench.cpp)
+    else()
+      set(BENCHMARK_MAIN ${BENCHMARK_COMPILE_BENCHMARK_MAIN})
+    endif()
+
+    ## Specify additional locations of benchmark files
+    if(DEFINED BENCHMARK_COMPILE_SOURCES)
+      list(APPEND BENCHMARK_SOURCES ${BENCHMARK_COMPILE_SOURCES})
+    endif()
+
+    add_executable(${LINK_TARGET} ${BENCHMARK_MAIN} ${BENCHMARK_SOURCES})
+    target_link_libraries(${LINK_TARGET} ${PROJECT_NAME} Threads::Threads)
+    target_compile_options(${LINK_TARGET} PRIVATE -O2)
+  else()
+    message(STATUS "Building Benchmarks Disabled")
+  endif()
+endfunction(add_benchmark_compile)
@@ -0,0 +1,290 @@
+//--------------------------------------------------------------------------------------------------------------------------------
+// Copyright 2024 Felix Biemüller, Technische Universität Darmstadt
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation
+// files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED  TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR  PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE
+//--------------------------------------------------------------------------------------------------------------------------------
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include <assert.h>
+#include <utility>
+
+#include "circular_lifo_buffer/circular_lifo_buffer.h"
+
+namespace circular_lifo_buffer
+{
+/**
+ * This class implements a circular LIFO buffer with one writer and several readers, which all receive the elements put
+ * inside. It is thread safe as long as only one thread puts elements into the buffer and each reader is used by a
+ * single thread only. The writer interface equals the one of CircularLifoBuffer, the readers are retrieved by
+ * getReader() and provide the read interface of CircularLifoBuffer.
+ *
+ * The buffer consists of NR_OF_READERS + 2 slots, so even if each reader holds a different slot there is always one slot
+ * left for the writer besides the one published last. The slot published last, the number of readers that took it
+ * over and a sequence number are stored in a single atomic word. A reader takes over the slot published last by
+ * incrementing this word and releases its previous slot by incrementing a counter of that slot. The writer publishes
+ * a slot by exchanging the word and adds the number of readers that took the previous slot over to its private
+ * bookkeeping. A slot is free as soon as all readers that took it over have released it. Thus neither the writer nor a
+ * reader ever waits for or retries because of another thread.
+ * @tparam NR_OF_READERS maximum number of reading threads
+ * @tparam Traits configuration of the buffer, only the Layout and MemoryOrdering are taken into account
+ */
+template <class T, size_t NR_OF_READERS, class Traits = DefaultBufferTraits>
+class BroadcastLifoBuffer
+{
+  static_assert(NR_OF_READERS > 0 && NR_OF_READERS + 2 < 0xFF, "Number of readers has to be between 1 and 252");
+
+  using Ordering = typename Traits::MemoryOrdering;
+  using Slot = detail::Slot<T, typename Traits::Layout>;
+  using Counter = detail::Slot<std::atomic<uint64_t>, typename Traits::Layout>;
+
+public:
+  /**
+   * Read interface of a single reader of the BroadcastLifoBuffer. Each reader may only be used by a single thread, but
+   * different readers can be used by different threads.
+   */
+  class Reader
+  {
+  public:
+    Reader(const Reader&) = delete;
+    Reader& operator=(const Reader&) = delete;
+
+    /**
+     * @brief This function can be used to query whether data was put inside the buffer since the last
+     * extraction of this reader
+     * @return true if data has been put inside
+     */
+    bool hasNewData() const { return sequenceOf(buffer_->state_.load(Ordering::POLL)) != last_sequence_; }
+
+    /**
+     * @brief Extracts an element of the buffer in case a new element was put inside it since the last
+     * extraction of this reader.
+     * @param target_reference reference to which the element type T should be written to. If no new element have been put
+     * inside the buffer the it is not overwritten.
+     * @return true if a new element was put inside since the last extraction and thus has been extracted
+     */
+    bool popIfNew(T& target_reference)
+    {
+      bool has_new_data;
+      const T* read_location = getNewReadAccessPtr(has_new_data);
+      if (has_new_data)
+      {
+        target_reference = *read_location;
+      }
+      return has_new_data;
+    }
+
+    /**
+     * @brief Extracts the element of the buffer that was written the most recent, no matter whether it has been read
+     * allready by this reader.
+     * @param target_reference reference to where the element of type T should be written to.
+     * @return true if a new element was written since the last extraction of this reader
+     */
+    bool pop(T& target_reference)
+    {
+      bool has_new_data;
+      const T* read_location = getNewReadAccessPtr(has_new_data);
+      target_reference = *read_location;
+      return has_new_data;
+    }
+
+    /**
+     * @brief Returns a pointer to the most recent element inside the buffer that can be read safely. The element is
+     * as long save to be read until the next extraction of this reader is performed.
+     * @return pointer to the element of type T that is the most recent that can be read safely
+     */
+    const T* getNewReadAccessPtr()
+    {
+      bool has_new_data;
+      return getNewReadAccessPtr(has_new_data);
+    }
+
+    /**
+     * @brief Returns a pointer to the most recent element inside the buffer that can be read safely. The element is
+     * as long save to be read until the next extraction of this reader is performed.
+     * @param has_new_data The reference is set to true, if a insert operation has been performed since the
+     * last extraction of this reader and else it is set to false.
+     * @return pointer to the most recently written element of type T that can be read safely
+     */
+    const T* getNewReadAccessPtr(bool& has_new_data)
+    {
+      const uint64_t state = buffer_->state_.load(Ordering::POLL);
+      if (held_slot_ != NO_SLOT && sequenceOf(state) == last_sequence_)
+      {
+        has_new_data = false;
+        return &buffer_->buffer_[held_slot_].value;
+      }
+
+      /* the previous slot is released before the newest one is taken over, so a reader never holds more than one slot */
+      if (held_slot_ != NO_SLOT)
+      {
+        buffer_->released_[held_slot_].value.fetch_add(1, Ordering::HANDOVER);
+      }
+      const uint64_t acquired_state = buffer_->state_.fetch_add(1, Ordering::HANDOVER);
+      held_slot_ = slotOf(acquired_state);
+      has_new_data = sequenceOf(acquired_state) != last_sequence_;
+      last_sequence_ = sequenceOf(acquired_state);
+      return &buffer_->buffer_[held_slot_].value;
+    }
+
+    /**
+     * @brief Returns the read access pointer that has been set by the last extraction of this reader.
+     * @return the last read access pointer that has been set or nullptr if this reader did not extract an element yet
+     */
+    const T* getLastSetReadAccessPtr() const { return held_slot_ == NO_SLOT ? nullptr : &buffer_->buffer_[held_slot_].value; }
+
+  private:
+    friend class BroadcastLifoBuffer;
+    friend struct detail::Slot<Reader, typename Traits::Layout>;
+
+    Reader() = default;
+
+    BroadcastLifoBuffer* buffer_ = nullptr;
+    uint8_t held_slot_ = NO_SLOT;
+    uint64_t last_sequence_ = 0;
+  };
+
+  BroadcastLifoBuffer()
+  {
+    state_.store(0, std::memory_order_relaxed);
+    for (size_t i = 0; i < SLOT_COUNT; i++)
+    {
+      released_[i].value.store(0, std::memory_order_relaxed);
+      acquired_[i] = 0;
+    }
+    for (auto& reader : readers_)
+    {
+      reader.value.buffer_ = this;
+    }
+  }
+
+  BroadcastLifoBuffer(const BroadcastLifoBuffer&) = delete;
+  BroadcastLifoBuffer& operator=(const BroadcastLifoBuffer&) = delete;
+
+  /**
+   * @brief Returns the read interface of one of the readers.
+   * @param reader_id id of the reader, which has to be smaller than NR_OF_READERS
+   * @return reference to the reader, which may only be used by a single thread
+   */
+  Reader& getReader(size_t reader_id)
+  {
+    assert(reader_id < NR_OF_READERS);
+    return readers_[reader_id].value;
+  }
+
+  /**
+   * @brief This function can be used to setup all elements of the buffer. The given function gets called sequentially
+   * with a reference to each element of the buffer.
+   * @param element_setup_function This setup function gets called with a reference for each element of the buffer
+   */
+  template <class SetupFunction>
+  void setupBufferElements(SetupFunction&& element_setup_function)
+  {
+    for (Slot& slot : buffer_)
+    {
+      element_setup_function(slot.value);
+    }
+  }
+
+  /**
+   * @brief Puts a new object of type T into the buffer by copying it
+   * @param new_data The data to be put inside.
+   */
+  void push(const T& new_data)
+  {
+    T* const write_location = getWriteAccessPtr();
+    *write_location = new_data;
+    indicateWriteDone();
+  }
+
+  /**
+   * @brief Puts a new object of type T into the buffer by moving it
+   * @param new_data The data to be put inside. It is left in the moved-from state.
+   */
+  void push(T&& new_data)
+  {
+    T* const write_location = getWriteAccessPtr();
+    *write_location = std::move(new_data);
+    indicateWriteDone();
+  }
+
+  /**
+   * @brief Returns a pointer to one element of the buffer that is neither the last one written nor held by any reader.
+   * When the modifications are completed indicateWriteDone() has to be called.
+   * @warning indicateWriteDone() should be called exactly one time before the next call to getWriteAccessPtr()
+   * happens and no modifications to the data should be done afterwards.
+   * @return pointer of type T to one element inside the buffer that can be overwritten
+   */
+  T* getWriteAccessPtr()
+  {
+    assert(!write_in_progress_);
+    write_in_progress_ = true;
+    for (uint8_t slot = 0; slot < SLOT_COUNT; slot++)
+    {
+      if (slot != latest_slot_ && released_[slot].value.load(Ordering::HANDOVER_LOAD) == acquired_[slot])
+      {
+        write_slot_ = slot;
+        return &buffer_[slot].value;
+      }
+    }
+    /* there are more slots than readers and the slot published last, so this is never reached */
+    assert(false);
+    return nullptr;
+  }
+
+  /**
+   * @brief Indicates that new data was written to the location that was retrieved by the last call of
+   * getWriteAccessPtr() and makes it available for all readers.
+   */
+  void indicateWriteDone()
+  {
+    assert(write_in_progress_);
+    sequence_++;
+    const uint64_t previous_state = state_.exchange((sequence_ << SEQUENCE_SHIFT) | (uint64_t(write_slot_) << SLOT_SHIFT), Ordering::HANDOVER);
+    acquired_[slotOf(previous_state)] += previous_state & COUNT_MASK;
+    latest_slot_ = write_slot_;
+    write_in_progress_ = false;
+  }
+
+private:
+  static constexpr uint8_t SLOT_COUNT = NR_OF_READERS + 2;
+  static constexpr uint8_t NO_SLOT = 0xFF;
+
+  /* layout of the state word: number of readers that took the slot over, index of the slot and sequence number */
+  static constexpr uint64_t COUNT_MASK = 0xFFFF;
+  static constexpr unsigned SLOT_SHIFT = 16;
+  static constexpr unsigned SEQUENCE_SHIFT = 24;
+
+  static uint8_t slotOf(uint64_t state) { return (state >> SLOT_SHIFT) & 0xFF; }
+  static uint64_t sequenceOf(uint64_t state) { return state >> SEQUENCE_SHIFT; }
+
+  Slot buffer_[SLOT_COUNT];
+  /* number of times each slot has been released by a reader */
+  Counter released_[SLOT_COUNT];
+  /* shared by the writer and all readers */
+  alignas(detail::ALIGNMENT_OF<typename Traits::Layout, std::atomic<uint64_t>>) std::atomic<uint64_t> state_;
+
+  /* only accessed by the writer: number of times each slot has been taken over by a reader */
+  alignas(detail::ALIGNMENT_OF<typename Traits::Layout, uint64_t>) uint64_t acquired_[SLOT_COUNT];
+  uint64_t sequence_ = 0;
+  uint8_t latest_slot_ = 0;
+  uint8_t write_slot_ = 0;
+  bool write_in_progress_ = false;
+
+  /* each reader is only accessed by its own thread */
+  detail::Slot<Reader, typename Traits::Layout> readers_[NR_OF_READERS];
+};
+}  // namespace circular_lifo_buffer
@@ -17,13 +17,73 @@
 #pragma once
 
 #include <stdint.h>
+#include <array>
 #include <atomic>
 #include <vector>
 #include <assert.h>
-#include <functional>
+#include <chrono>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "circular_lifo_buffer/element_assignments.h"
+#include "circular_lifo_buffer/index_protocols.h"
+#include "circular_lifo_buffer/instrumentations.h"
+#include "circular_lifo_buffer/layouts.h"
+#include "circular_lifo_buffer/memory_orderings.h"
+#include "circular_lifo_buffer/probes.h"
+#include "circular_lifo_buffer/publish_timestamps.h"
+#include "circular_lifo_buffer/storage_strategies.h"
+#include "circular_lifo_buffer/wait_strategies.h"
 
 namespace circular_lifo_buffer
 {
+/**
+ * Default configuration of the CircularLifoBuffer. In order to change single options a struct can be derived from it,
+ * which overrides the corresponding members, e.g.
+ * @code
+ * struct WaitFreeTraits : DefaultBufferTraits
+ * {
+ *   using Strategy = TripleBufferStrategy;
+ *   using IndexProtocol = WaitFreeProtocol;
+ * };
+ * CircularLifoBuffer<int, WaitFreeTraits> buffer;
+ * @endcode
+ */
+struct DefaultBufferTraits
+{
+  /** Strategy used to store the elements, either AutomaticStrategy, TripleBufferStrategy, DoubleBufferStrategy,
+   * SeqlockStrategy, AtomicValueStrategy or ExternalSlotsStrategy */
+  using Strategy = AutomaticStrategy;
+  /** Protocol used by the TripleBufferStrategy and the ExternalSlotsStrategy to assign the slots to the writer and the
+   * reader, either RetryLoopProtocol or WaitFreeProtocol. The other strategies ignore it, so together with the
+   * AutomaticStrategy it only applies to types for which the TripleBufferStrategy is selected */
+  using IndexProtocol = RetryLoopProtocol;
+  /** Memory layout of the buffer, either PackedLayout or CacheLineIsolatedLayout */
+  using Layout = PackedLayout;
+  /** Memory ordering of the atomic operations, either SeqCstOrdering or AcquireReleaseOrdering */
+  using MemoryOrdering = SeqCstOrdering;
+  /** Strategy used by the reader to wait for new data, either PollingWait or FutexWait */
+  using WaitStrategy = PollingWait;
+  /** Assignment used to put elements into the buffer and to extract them, either DefaultAssignment or
+   * CapacityPreservingAssignment */
+  using Assignment = DefaultAssignment;
+  /** Instrumentation of the operations, either NoInstrumentation or HistogramInstrumentation */
+  using Instrumentation = NoInstrumentation;
+  /** Whether the time of each publish is stored with the element, either NoPublishTimestamps or
+   * SteadyClockPublishTimestamps */
+  using PublishTimestamps = NoPublishTimestamps;
+};
+
+/**
+ * Tag selecting the constructor of CircularLifoBuffer that constructs each element from the result of a factory.
+ */
+struct InPlaceFactory
+{
+  explicit InPlaceFactory() = default;
+};
+inline constexpr InPlaceFactory in_place_factory{};
+
 /**
  * This class implements a circular buffer that behaves as last in first out (LIFO) data structure.
  * It is thread safe for two threads as long as only one thread puts elements into the buffer and only the other thread
@@ -31,31 +91,79 @@ namespace circular_lifo_buffer
  * popIfNew(T& target_reference) also more advanced operations are provided for enabling implementations with more memory
  * efficiency. For these advanced operations the documentation should be read carefully as certain constraints like the
  * the order of the function calls have to be met in order to keep the data consistent and the accesses threadsafe.
+ * The behaviour of the buffer can be configured by the Traits, see DefaultBufferTraits. By default the way the elements
+ * are stored is selected depending on T, see AutomaticStrategy. The seqlock based strategies transfer the elements
+ * between private copies of the writer and the reader, so the pointers returned by the advanced operations refer to
+ * these copies, but they remain valid for the same time.
  */
-template <class T>
+template <class T, class Traits = DefaultBufferTraits>
 class CircularLifoBuffer
 {
+  using Storage = typename Traits::Strategy::template Implementation<T, Traits>;
+  using WaitStrategy = typename Traits::WaitStrategy::template Implementation<Traits>;
+  using Assignment = typename Traits::Assignment::template Implementation<T, Traits>;
+  using Instrumentation = typename Traits::Instrumentation::template Implementation<Traits>;
+  using LoopCounter = typename Instrumentation::LoopCounter;
+  using PublishClock = typename Traits::PublishTimestamps::template Implementation<Traits>;
+
 public:
-  CircularLifoBuffer()
+  /**
+   * @brief Value initializes every element of the buffer, so T has to be default constructible.
+   */
+  CircularLifoBuffer() : storage_([](void* location) { new (location) T(); }) {}
+
+  /**
+   * @brief Constructs every element of the buffer in place from the given arguments, e.g. to reserve the capacity of
+   * containers before the buffer is used, so no allocation is needed afterwards.
+   * @param args The arguments passed to the constructor of each element. As they are used for several elements, they
+   * are never moved from.
+   */
+  template <class... Args>
+  explicit CircularLifoBuffer(std::in_place_t, const Args&... args) : storage_([&args...](void* location) { new (location) T(args...); })
   {
-    last_written_.store(0, std::memory_order_relaxed);
-    current_read_.store(0, std::memory_order_relaxed);
   }
 
   /**
-   * @brief This function can be used to setup all elements of the buffer. It takes a function
-   * object which takes a reference of Type T as argument. The given function gets called sequentially with a reference to
-   * each element of the buffer.
+   * @brief Constructs every element of the buffer in place from the object returned by the given factory.
+   * @param factory function object without arguments returning an object of type T, which is called once per element
+   */
+  template <class Factory>
+  CircularLifoBuffer(InPlaceFactory, Factory&& factory) : storage_([&factory](void* location) { new (location) T(factory()); })
+  {
+  }
+
+  /**
+   * @brief Uses three elements provided by the caller as the slots, e.g. buffers mapped from a driver, so they are
+   * handed over between the writer and the reader without copying. Requires the ExternalSlotsStrategy. The elements
+   * have to be constructed already and outlive the buffer, which never constructs or destroys them.
+   * @param slots addresses of three distinct elements
+   * @throw std::invalid_argument if an address is null, not aligned or given twice
+   */
+  explicit CircularLifoBuffer(const std::array<T*, 3>& slots) : storage_(slots) {}
+
+  CircularLifoBuffer(const CircularLifoBuffer&) = delete;
+  CircularLifoBuffer& operator=(const CircularLifoBuffer&) = delete;
+
+  /**
+   * @brief This function can be used to setup all elements of the buffer. The given function gets called sequentially
+   * with a reference to each element of the buffer.
    * @param element_setup_function This setup function gets called with a reference for each element of the buffer
-   * @warning After the instantiation of the Circular Buffer the data refers to uninitialized memory and hence the
-   * constructor of the elements might need to be called in the element_setup_function.
    */
-  void setupBufferElements(std::function<void(T&)> element_setup_function)
+  template <class SetupFunction>
+  void setupBufferElements(SetupFunction&& element_setup_function)
   {
-    for (int i = 0; i < BUFFER_SIZE; i++)
-    {
-      element_setup_function(buffer_[i]);
-    }
+    storage_.setup(element_setup_function);
+  }
+
+  /**
+   * @brief Reserves the given capacity in all elements of the buffer, which have to be containers like std::vector or
+   * std::string. Together with the CapacityPreservingAssignment no allocation happens afterwards while the elements put
+   * inside and the targets extracted to fit into this capacity.
+   * @param capacity number of items reserved in each element
+   */
+  void reserveElements(size_t capacity)
+  {
+    setupBufferElements([capacity](T& element) { element.reserve(capacity); });
   }
 
   /**
@@ -63,16 +171,106 @@ public:
    * extraction
    * @return true if data has been put inside
    */
-  bool hasNewData() const { return current_read_.load(std::memory_order_seq_cst) != last_written_.load(std::memory_order_seq_cst); }
+  bool hasNewData() const { return storage_.hasNewData(); }
 
   /**
-   * @brief Puts a new object of type T into the buffer
+   * @brief Blocks until data was put inside the buffer since the last extraction. How the thread waits is determined by
+   * the WaitStrategy of the Traits.
+   */
+  void waitForNewData() { waitForNewDataUntil(std::chrono::steady_clock::time_point::max()); }
+
+  /**
+   * @brief Blocks until data was put inside the buffer since the last extraction or the deadline is reached.
+   * @param deadline point in time after which the function returns even if no new data was put inside
+   * @return true if data has been put inside
+   */
+  template <class Clock, class Duration>
+  bool waitForNewDataUntil(const std::chrono::time_point<Clock, Duration>& deadline)
+  {
+    return wait_strategy_.waitUntil([this]() { return hasNewData(); }, deadline);
+  }
+
+  /**
+   * @brief Waits for a new element like waitForNewDataUntil() and extracts it like popIfNew().
+   * @param target_reference reference to which the element type T should be written to. If no new element has been put
+   * inside the buffer until the timeout expired it is not overwritten.
+   * @param timeout maximum duration to wait for a new element, durations beyond the range of the steady clock like
+   * duration::max() wait without a timeout
+   * @return true if a new element was put inside since the last extraction and thus has been extracted
+   */
+  template <class Rep, class Period>
+  bool popWait(T& target_reference, const std::chrono::duration<Rep, Period>& timeout)
+  {
+    using Clock = std::chrono::steady_clock;
+    const Clock::time_point now = Clock::now();
+    /* compared as floating point durations, as converting the timeout to the clock duration may overflow itself */
+    const bool is_beyond_range = std::chrono::duration<double>(timeout) >= std::chrono::duration<double>(Clock::time_point::max() - now);
+    waitForNewDataUntil(is_beyond_range ? Clock::time_point::max() : now + std::chrono::duration_cast<Clock::duration>(timeout));
+    return popIfNew(target_reference);
+  }
+
+  /**
+   * @brief Puts a new object of type T into the buffer by copying it
    * @param new_data The data to be put inside.
    */
-  void push(T& new_data)
+  void push(const T& new_data)
+  {
+    T* const write_location = getWriteAccessPtr();
+    writer_assignment_.copy(*write_location, new_data);
+    indicateWriteDone();
+  }
+
+  /**
+   * @brief Puts a new object of type T into the buffer by moving it, which avoids a deep copy of e.g. containers
+   * @param new_data The data to be put inside. It is left in the moved-from state.
+   */
+  void push(T&& new_data)
+  {
+    T* const write_location = getWriteAccessPtr();
+    writer_assignment_.move(*write_location, std::move(new_data));
+    indicateWriteDone();
+  }
+
+  /**
+   * @brief Puts a new object of type T into the buffer, which is constructed directly inside the buffer from the given
+   * arguments. The element previously stored at this position is destroyed beforehand.
+   * @param args The arguments forwarded to the constructor of T
+   * @warning If the constructor throws an exception, the element is default constructed instead and nothing is put
+   * inside the buffer. If T is not default constructible or the element is the one published last, which the
+   * DoubleBufferStrategy overwrites if the reader did not take it over yet, the new element is constructed outside of
+   * the buffer and move assigned to the element instead, so it is left unchanged if the constructor throws.
+   */
+  template <class... Args>
+  void emplace(Args&&... args)
   {
     T* const write_location = getWriteAccessPtr();
-    *write_location = new_data;
+    if constexpr (std::is_nothrow_constructible<T, Args...>::value)
+    {
+      write_location->~T();
+      new (write_location) T(std::forward<Args>(args)...);
+    }
+    else if constexpr (!std::is_default_constructible<T>::value)
+    {
+      emplaceByAssignment(write_location, std::forward<Args>(args)...);
+    }
+    else if (storage_.overwritesPublishedElement())
+    {
+      emplaceByAssignment(write_location, std::forward<Args>(args)...);
+    }
+    else
+    {
+      write_location->~T();
+      try
+      {
+        new (write_location) T(std::forward<Args>(args)...);
+      }
+      catch (...)
+      {
+        new (write_location) T();
+        abortWrite();
+        throw;
+      }
+    }
     indicateWriteDone();
   }
 
@@ -89,7 +287,7 @@ public:
     const T* read_location = getNewReadAccessPtr(has_new_data);
     if (has_new_data)
     {
-      target_reference = *read_location;
+      reader_assignment_.copy(target_reference, *read_location);
     }
     return has_new_data;
   }
@@ -97,8 +295,6 @@ public:
   /**
    * @brief Extracts the element of the buffer that was written the most recent, no matter whether it has been read
    * allready.
-   * @warning If the buffer elements were not initialized with setupBufferElements() the data extracted by
-   * this method is uninitialized until the first element was inserted.
    * @param target_reference reference to where the element of type T should be written to.
    *  The target of this reference is overwritten in anycase, even if no element was inserted in the buffer yet.
    * @return true if a new element was written since the last extraction
@@ -108,8 +304,58 @@ public:
     bool has_new_data;
     const T* read_location = getNewReadAccessPtr(has_new_data);
 
-    target_reference = *read_location;
+    reader_assignment_.copy(target_reference, *read_location);
+
+    return has_new_data;
+  }
+
+  /**
+   * @brief Extracts an element of the buffer in case a new element was put inside it since the last extraction by
+   * swapping it with the object given. In contrast to popIfNew() no copy is performed, so e.g. the storage of
+   * containers is exchanged in constant time without allocations. The object given is put into the buffer instead and
+   * its storage is reused by the writer later on.
+   * @warning Until a new element is extracted, getLastSetReadAccessPtr() and the pointers retrieved by
+   * getNewReadAccessPtr() as well as pop() refer to the object that was given to this function instead of the element
+   * extracted.
+   * @param target_reference reference to the object that should be exchanged with the element. If no new element has
+   * been put inside the buffer it is not modified.
+   * @return true if a new element was put inside since the last extraction and thus has been extracted
+   */
+  bool exchangeIfNew(T& target_reference)
+  {
+    bool has_new_data;
+    T* const read_location = getNewReadAccessPtr(has_new_data);
+    if (has_new_data)
+    {
+      using std::swap;
+      swap(target_reference, *read_location);
+      read_location_exchanged_ = true;
+    }
+    return has_new_data;
+  }
 
+  /**
+   * @brief Extracts the element of the buffer that was written the most recent like pop(), but a new element is
+   * swapped with the object given as by exchangeIfNew(). If no new element was put inside since the last extraction and
+   * the last one was extracted by popSwap() or exchangeIfNew() the object given is expected to still hold it and is not
+   * modified, otherwise the element is copied.
+   * @param target_reference reference to where the element of type T should be written to.
+   * @return true if a new element was written since the last extraction
+   */
+  bool popSwap(T& target_reference)
+  {
+    bool has_new_data;
+    T* const read_location = getNewReadAccessPtr(has_new_data);
+    if (has_new_data)
+    {
+      using std::swap;
+      swap(target_reference, *read_location);
+      read_location_exchanged_ = true;
+    }
+    else if (!read_location_exchanged_)
+    {
+      reader_assignment_.copy(target_reference, *read_location);
+    }
     return has_new_data;
   }
 
@@ -127,8 +373,12 @@ public:
     assert(!write_in_progress_);
 
     write_in_progress_ = true;
-    setNextWritePosition();
-    return &buffer_[next_write_position_];
+    const auto start_time = instrumentation_.start();
+    LoopCounter loop_counter;
+    T* const write_location = storage_.acquireWriteLocation(loop_counter);
+    instrumentation_.recordGetWriteAccessPtr(start_time, loop_counter);
+    CIRCULAR_LIFO_BUFFER_PROBE(write_acquire, this, storage_.writeSlot(), storage_.writeSequenceNumber());
+    return write_location;
   }
   /**
    * @brief Indicates that new data was written to the location that was retrieved by the last call of
@@ -139,16 +389,18 @@ public:
   void indicateWriteDone()
   {
     assert(write_in_progress_);
-    last_written_.store(next_write_position_, std::memory_order_seq_cst);
+    CIRCULAR_LIFO_BUFFER_PROBE(write_publish, this, storage_.writeSlot(), storage_.writeSequenceNumber());
+    const auto start_time = instrumentation_.start();
+    storage_.publish();
+    wait_strategy_.notify();
     write_in_progress_ = false;
+    instrumentation_.recordIndicateWriteDone(start_time, LoopCounter());
   }
 
   /**
    * @brief Returns a pointer to the most recent element inside the buffer that can be read safely. The
    * element is as long save to be read until the next extraction is performed eg. by  getNewReadAccessPtr(),
    * getNewReadAccessPtr(bool& has_new_data), pop(T& target_reference) or popIfNew(T& target_reference).
-   * @warning If the buffer elements were not initialized with setupBufferElements() the pointer refers to an uninitialized
-   * element until the first element was inserted.
    * @return pointer to the element of type T that is the most recent that can be read safely
    */
   T* const getNewReadAccessPtr()
@@ -163,12 +415,85 @@ public:
    * getNewReadAccessPtr(bool& has_new_data), pop(T& target_reference) or popIfNew(T& target_reference).
    * @param has_new_data The reference is set to true, if a insert operation has been performed since the
    * last extraction and else it is set to false.
-   * @warning If the buffer elements were not initialized with setupBufferElements() the pointer refers to an uninitialized
-   * element until the first element was inserted.
    * @return pointer to the most recently written element of type T that can be read safely
    */
   T* const getNewReadAccessPtr(bool& has_new_data) { return getAndSetCurrentReadPosition(has_new_data); }
 
+  /**
+   * @brief Returns a pointer to the most recent element inside the buffer that can be read safely like
+   * getNewReadAccessPtr(bool& has_new_data) and additionally provides the sequence number of the element.
+   * @param has_new_data The reference is set to true, if a insert operation has been performed since the
+   * last extraction and else it is set to false.
+   * @param sequence_number The reference is set to the sequence number of the element, see getLastReadSequenceNumber()
+   * @return pointer to the most recently written element of type T that can be read safely
+   */
+  T* const getNewReadAccessPtr(bool& has_new_data, uint64_t& sequence_number)
+  {
+    T* const read_location = getAndSetCurrentReadPosition(has_new_data);
+    sequence_number = last_read_sequence_number_;
+    return read_location;
+  }
+
+  /**
+   * @brief Returns the sequence number of the element extracted last by any of the read operations. The elements are
+   * numbered consecutively starting with 1 in the order they are put inside the buffer, 0 means that no element has been
+   * extracted yet.
+   * @return sequence number of the element extracted last
+   */
+  uint64_t getLastReadSequenceNumber() const { return last_read_sequence_number_; }
+
+  /**
+   * @brief Returns the time the element extracted last was published by indicateWriteDone(). Requires the
+   * SteadyClockPublishTimestamps. Must only be called by the reader.
+   * @return publish time of the element extracted last, the epoch of the steady clock if none has been extracted yet
+   */
+  std::chrono::steady_clock::time_point getLastReadPublishTime() const
+  {
+    static_assert(PublishClock::ENABLED, "Publish timestamps have to be enabled by the SteadyClockPublishTimestamps");
+    return last_read_publish_time_;
+  }
+
+  /**
+   * @brief Returns how old the element extracted last is, i.e. the time since it was published by indicateWriteDone().
+   * Calling this when the element is used yields its age at use. Requires the SteadyClockPublishTimestamps. Must only
+   * be called by the reader.
+   * @return time elapsed since the element extracted last was published
+   */
+  std::chrono::nanoseconds age() const { return std::chrono::steady_clock::now() - getLastReadPublishTime(); }
+
+  /**
+   * @brief Returns the time from the publish of the element extracted last until the reader extracted it for the first
+   * time, which includes the time the reader did not look for new data. Requires the SteadyClockPublishTimestamps.
+   * Must only be called by the reader.
+   * @return delay until the element extracted last became visible to the reader
+   */
+  std::chrono::nanoseconds getVisibilityDelay() const
+  {
+    static_assert(PublishClock::ENABLED, "Publish timestamps have to be enabled by the SteadyClockPublishTimestamps");
+    return visibility_delay_;
+  }
+
+  /**
+   * @brief Returns the number of elements that have been overwritten without being extracted between the element
+   * extracted last and the one extracted before, e.g. to detect dropped cycles.
+   * @return number of elements skipped by the last extraction of a new element
+   */
+  uint64_t getNrOfSkippedElements() const { return nr_of_skipped_elements_; }
+
+  /**
+   * @brief Returns the number of allocations that happened while push() assigned elements, which are only counted by
+   * the CapacityPreservingAssignment. Must only be called by the writer.
+   * @return number of assignments that changed the capacity of an element of the buffer
+   */
+  uint64_t getNrOfWriteAllocations() const { return writer_assignment_.nrOfAllocations(); }
+
+  /**
+   * @brief Returns the number of allocations that happened while pop() and popIfNew() assigned the target, which are
+   * only counted by the CapacityPreservingAssignment. Must only be called by the reader.
+   * @return number of assignments that changed the capacity of the target
+   */
+  uint64_t getNrOfReadAllocations() const { return reader_assignment_.nrOfAllocations(); }
+
   /**
    * @brief Returns the read access pointer that has been set by the last call of pop() or getNewReadAccessPtr().
    * @warning If this function is used the pointer will only point to valid data until the next call of pop() or
@@ -179,53 +504,109 @@ public:
    * variable, it is more efficient to store the pointer retrived by getNewReadAccessPtr() instead of using this method.
    * @return the last read access pointer that has been set
    */
-  T* const getLastSetReadAccessPtr() { return &buffer_[current_read_.load(std::memory_order_relaxed)]; }
+  T* const getLastSetReadAccessPtr() { return storage_.lastReadLocation(); }
 
-private:
-  static const uint8_t BUFFER_SIZE = 3;
+  /**
+   * @brief Returns the histograms recorded by the HistogramInstrumentation since the last call of
+   * resetInstrumentation(). Both have to be called by the same thread, see HistogramInstrumentation. Concurrent
+   * operations may be missing in the snapshot.
+   * @return durations and loop iterations of getWriteAccessPtr(), indicateWriteDone() and getNewReadAccessPtr()
+   */
+  InstrumentationSnapshot getInstrumentationSnapshot() const { return instrumentation_.snapshot(); }
+
+  /**
+   * @brief Restarts the histograms returned by getInstrumentationSnapshot() without disturbing the writer and reader.
+   * Has to be called by the thread calling getInstrumentationSnapshot(), see HistogramInstrumentation.
+   */
+  void resetInstrumentation() { instrumentation_.reset(); }
+
+  /**
+   * @brief Repairs the state of the writer after the thread writing stopped at an arbitrary point, e.g. because the
+   * process it belongs to died while the buffer is placed in shared memory. A write started by getWriteAccessPtr() is
+   * discarded and the element it may have modified partially is restored from the one published last, so no torn
+   * element is ever published. Requires the TripleBufferStrategy with the WaitFreeProtocol. Must be called by the new
+   * writer before it accesses the buffer, while the reader may continue.
+   * @param is_reader_stopped function returning true if the reader is not running at the moment, e.g. because it
+   * stopped as well, in which case the slot it holds may have to be recovered by recoverReader() later
+   */
+  template <class Predicate>
+  void recoverWriter(Predicate&& is_reader_stopped)
+  {
+    storage_.recoverWriter(is_reader_stopped);
+    write_in_progress_ = false;
+  }
 
-  T buffer_[BUFFER_SIZE];
-  std::atomic<uint8_t> last_written_;
-  std::atomic<uint8_t> current_read_;
+  /**
+   * @brief Repairs the state of the reader after the thread reading stopped at an arbitrary point like
+   * recoverWriter(). The element read last stays untouched. Requires the TripleBufferStrategy with the WaitFreeProtocol.
+   * Must be called by the new reader before it accesses the buffer, while the writer may continue.
+   * @param is_writer_stopped function returning true if the writer is not running at the moment
+   */
+  template <class Predicate>
+  void recoverReader(Predicate&& is_writer_stopped)
+  {
+    storage_.recoverReader(is_writer_stopped);
+  }
 
-  uint8_t next_write_position_ = 0;
+private:
+  Storage storage_;
+  WaitStrategy wait_strategy_;
+  Instrumentation instrumentation_;
 
-  void setNextWritePosition()
+  /* constructs the element outside of the buffer, so the element at the write location is left unchanged if the
+   * constructor throws */
+  template <class... Args>
+  void emplaceByAssignment(T* write_location, Args&&... args)
   {
-    int current_read_val;
-    int current_write_val;
-    do
+    try
     {
-      next_write_position_ = (next_write_position_ + 1) % BUFFER_SIZE;
-      current_read_val = current_read_.load(std::memory_order_seq_cst);
-      current_write_val = last_written_.load(std::memory_order_seq_cst);
-    } while (!(next_write_position_ != current_read_val && next_write_position_ != current_write_val));
-    assert(next_write_position_ >= 0 && next_write_position_ < BUFFER_SIZE);
+      *write_location = T(std::forward<Args>(args)...);
+    }
+    catch (...)
+    {
+      abortWrite();
+      throw;
+    }
+  }
+
+  /* ends the write started by getWriteAccessPtr() without publishing, e.g. because the constructor of the element threw */
+  void abortWrite()
+  {
+    storage_.abortWrite();
+    write_in_progress_ = false;
   }
 
   T* const getAndSetCurrentReadPosition(bool& is_new_position)
   {
-    uint8_t last_written_ptr;
-    uint8_t old_read_pointer;
-
-    /* The following while loop is critical to ensure that last_written has not changed between the load and exchange
-     * operation otherwise there is a point in time, where last written could have been already changed and current_read
-     * has not changed yet to its new value, so SetNextWritePosition() could select the position which is about to be
-     * stored in current_read.
-     */
-    /* In theory this could lead to read starvation, but as the writer has to write the buffer entry in the mean time
-     * and generate new data to be written, this should be no problem in a practical application.
-     */
-    do
+    typename Storage::Record publish_record;
+    const auto start_time = instrumentation_.start();
+    LoopCounter loop_counter;
+    T* const read_location = storage_.acquireReadLocation(is_new_position, publish_record, loop_counter);
+    if (is_new_position)
     {
-      last_written_ptr = last_written_.load(std::memory_order_seq_cst);
-      old_read_pointer = current_read_.exchange(last_written_ptr, std::memory_order_seq_cst);
-    } while (last_written_.load(std::memory_order_seq_cst) != last_written_ptr);
-
-    is_new_position = old_read_pointer != last_written_ptr;
-    return &buffer_[last_written_ptr];
+      read_location_exchanged_ = false;
+      nr_of_skipped_elements_ = publish_record.sequence_number - last_read_sequence_number_ - 1;
+      last_read_sequence_number_ = publish_record.sequence_number;
+      if constexpr (PublishClock::ENABLED)
+      {
+        last_read_publish_time_ = publish_record.publish_time;
+        visibility_delay_ = PublishClock::now() - publish_record.publish_time;
+      }
+    }
+    instrumentation_.recordGetNewReadAccessPtr(start_time, loop_counter);
+    CIRCULAR_LIFO_BUFFER_PROBE(read_acquire, this, storage_.readSlot(), last_read_sequence_number_);
+    return read_location;
   }
 
-  bool write_in_progress_ = false;
+  /* only accessed by the writer */
+  alignas(Traits::Layout::ALIGNMENT) bool write_in_progress_ = false;
+  Assignment writer_assignment_;
+  /* only accessed by the reader, true if the element read last was swapped out of the buffer */
+  alignas(Traits::Layout::ALIGNMENT) bool read_location_exchanged_ = false;
+  uint64_t last_read_sequence_number_ = 0;
+  uint64_t nr_of_skipped_elements_ = 0;
+  Assignment reader_assignment_;
+  typename PublishClock::Timestamp last_read_publish_time_{};
+  std::chrono::nanoseconds visibility_delay_{ 0 };
 };
 }  // namespace circular_lifo_buffer
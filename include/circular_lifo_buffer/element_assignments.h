@@ -0,0 +1,89 @@
+//--------------------------------------------------------------------------------------------------------------------------------
+// Copyright 2024 Felix Biemüller, Technische Universität Darmstadt
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation
+// files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED  TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR  PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE
+//--------------------------------------------------------------------------------------------------------------------------------
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <utility>
+
+namespace circular_lifo_buffer
+{
+namespace detail
+{
+/**
+ * Assigns the elements by the copy and move assignment operators of T. Allocations are not tracked.
+ */
+template <class T, class Traits>
+class DefaultAssignment
+{
+public:
+  void copy(T& target, const T& source) { target = source; }
+
+  void move(T& target, T&& source) { target = std::move(source); }
+
+  uint64_t nrOfAllocations() const { return 0; }
+};
+
+/**
+ * Assigns containers like std::vector or std::string such that the target keeps its storage whenever its capacity
+ * suffices. Elements are copied even if they are moved into the buffer, as moving would replace the storage of the slot
+ * by the one of the source, which may have a smaller capacity. Each assignment that changes the capacity of the target
+ * had to allocate and is counted.
+ */
+template <class T, class Traits>
+class CapacityPreservingAssignment
+{
+public:
+  void copy(T& target, const T& source)
+  {
+    const size_t capacity = target.capacity();
+    target = source;
+    if (target.capacity() != capacity)
+    {
+      nr_of_allocations_++;
+    }
+  }
+
+  void move(T& target, T&& source) { copy(target, source); }
+
+  uint64_t nrOfAllocations() const { return nr_of_allocations_; }
+
+private:
+  uint64_t nr_of_allocations_ = 0;
+};
+}  // namespace detail
+
+/**
+ * Selects the copy and move assignment of T for putting elements into the buffer and extracting them.
+ */
+struct DefaultAssignment
+{
+  template <class T, class Traits>
+  using Implementation = detail::DefaultAssignment<T, Traits>;
+};
+
+/**
+ * Selects the assignment for containers, which keeps the storage of the slots and of the targets extracted to, so no
+ * allocation happens once their capacity has been reserved. Allocations that happen anyway are counted. Requires a
+ * type providing capacity() like std::vector or std::string.
+ */
+struct CapacityPreservingAssignment
+{
+  template <class T, class Traits>
+  using Implementation = detail::CapacityPreservingAssignment<T, Traits>;
+};
+}  // namespace circular_lifo_buffer
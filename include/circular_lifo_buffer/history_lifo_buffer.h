@@ -0,0 +1,306 @@
+//--------------------------------------------------------------------------------------------------------------------------------
+// Copyright 2024 Felix Biemüller, Technische Universität Darmstadt
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation
+// files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED  TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR  PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE
+//--------------------------------------------------------------------------------------------------------------------------------
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <assert.h>
+#include <utility>
+
+#include "circular_lifo_buffer/circular_lifo_buffer.h"
+
+namespace circular_lifo_buffer
+{
+/**
+ * This class implements a circular LIFO buffer that keeps the last HISTORY_DEPTH published elements available for the
+ * reader. It is thread safe as long as only one thread puts elements into the buffer and one thread extracts them. The
+ * interface equals the one of CircularLifoBuffer, getHistory() additionally provides the last published elements.
+ *
+ * The buffer consists of 2 * HISTORY_DEPTH + 1 slots, so there is always one slot left for the writer besides the
+ * HISTORY_DEPTH slots published last and the HISTORY_DEPTH slots held by the reader. The list of published slots, the
+ * set of slots held by the reader and the number of elements published since the last extraction are stored in a single
+ * atomic word. The writer publishes by shifting its slot into the list, the reader takes over the list as its set of
+ * held slots, both by a compare-and-swap. Hence the writer never waits for the reader, but may repeat its
+ * compare-and-swap once for each extraction the reader performs at the same time.
+ * @tparam HISTORY_DEPTH number of elements published last that are available to the reader, between 1 and 7
+ * @tparam Traits configuration of the buffer, only the Layout and MemoryOrdering are taken into account
+ */
+template <class T, size_t HISTORY_DEPTH, class Traits = DefaultBufferTraits>
+class HistoryLifoBuffer
+{
+  static_assert(HISTORY_DEPTH > 0 && HISTORY_DEPTH <= 7, "History depth has to be between 1 and 7");
+
+  using Ordering = typename Traits::MemoryOrdering;
+  using Slot = detail::Slot<T, typename Traits::Layout>;
+
+public:
+  HistoryLifoBuffer()
+  {
+    /* the reader holds slot 0 until the first element is published, so the initial element can be read safely */
+    state_.store(uint64_t(1) << HELD_SHIFT, std::memory_order_relaxed);
+  }
+
+  HistoryLifoBuffer(const HistoryLifoBuffer&) = delete;
+  HistoryLifoBuffer& operator=(const HistoryLifoBuffer&) = delete;
+
+  /**
+   * @brief This function can be used to setup all elements of the buffer. The given function gets called sequentially
+   * with a reference to each element of the buffer.
+   * @param element_setup_function This setup function gets called with a reference for each element of the buffer
+   */
+  template <class SetupFunction>
+  void setupBufferElements(SetupFunction&& element_setup_function)
+  {
+    for (Slot& slot : buffer_)
+    {
+      element_setup_function(slot.value);
+    }
+  }
+
+  /**
+   * @brief This function can be used to query whether data was put inside the buffer since the last extraction
+   * @return true if data has been put inside
+   */
+  bool hasNewData() const { return newCountOf(state_.load(Ordering::POLL)) != 0; }
+
+  /**
+   * @brief Puts a new object of type T into the buffer by copying it
+   * @param new_data The data to be put inside.
+   */
+  void push(const T& new_data)
+  {
+    T* const write_location = getWriteAccessPtr();
+    *write_location = new_data;
+    indicateWriteDone();
+  }
+
+  /**
+   * @brief Puts a new object of type T into the buffer by moving it
+   * @param new_data The data to be put inside. It is left in the moved-from state.
+   */
+  void push(T&& new_data)
+  {
+    T* const write_location = getWriteAccessPtr();
+    *write_location = std::move(new_data);
+    indicateWriteDone();
+  }
+
+  /**
+   * @brief Extracts an element of the buffer in case a new element was put inside it since the last
+   * extraction.
+   * @param target_reference reference to which the element type T should be written to. If no new element have been put
+   * inside the buffer the it is not overwritten.
+   * @return true if a new element was put inside since the last extraction and thus has been extracted
+   */
+  bool popIfNew(T& target_reference)
+  {
+    bool has_new_data;
+    const T* read_location = getNewReadAccessPtr(has_new_data);
+    if (has_new_data)
+    {
+      target_reference = *read_location;
+    }
+    return has_new_data;
+  }
+
+  /**
+   * @brief Extracts the element of the buffer that was written the most recent, no matter whether it has been read
+   * allready.
+   * @param target_reference reference to where the element of type T should be written to.
+   * @return true if a new element was written since the last extraction
+   */
+  bool pop(T& target_reference)
+  {
+    bool has_new_data;
+    const T* read_location = getNewReadAccessPtr(has_new_data);
+    target_reference = *read_location;
+    return has_new_data;
+  }
+
+  /**
+   * @brief Returns a pointer to one element of the buffer that is neither published nor held by the reader. When the
+   * modifications are completed indicateWriteDone() has to be called.
+   * @warning indicateWriteDone() should be called exactly one time before the next call to getWriteAccessPtr()
+   * happens and no modifications to the data should be done afterwards.
+   * @return pointer of type T to one element inside the buffer that can be overwritten
+   */
+  T* getWriteAccessPtr()
+  {
+    assert(!write_in_progress_);
+    write_in_progress_ = true;
+    return &buffer_[write_slot_].value;
+  }
+
+  /**
+   * @brief Indicates that new data was written to the location that was retrieved by the last call of
+   * getWriteAccessPtr() and makes it the newest element of the history.
+   */
+  void indicateWriteDone()
+  {
+    assert(write_in_progress_);
+    uint64_t state = state_.load(Ordering::POLL);
+    uint64_t new_state;
+    do
+    {
+      const uint64_t published = ((state & PUBLISHED_MASK) << INDEX_BITS | write_slot_) & PUBLISHED_MASK;
+      const uint64_t published_count = std::min<uint64_t>(publishedCountOf(state) + 1, HISTORY_DEPTH);
+      const uint64_t new_count = std::min<uint64_t>(newCountOf(state) + 1, HISTORY_DEPTH);
+      new_state = published | (state & HELD_MASK) | (published_count << PUBLISHED_COUNT_SHIFT) | (new_count << NEW_COUNT_SHIFT);
+    } while (!state_.compare_exchange_weak(state, new_state, Ordering::HANDOVER, Ordering::POLL));
+
+    /* the reader can only take over slots of the published list, so a slot that is neither in the list nor held by the
+     * reader at the time of publishing stays free */
+    const uint64_t occupied = slotMaskOf(new_state) | heldMaskOf(new_state);
+    write_slot_ = 0;
+    while ((occupied >> write_slot_) & 1)
+    {
+      write_slot_++;
+    }
+    write_in_progress_ = false;
+  }
+
+  /**
+   * @brief Returns a pointer to the most recent element inside the buffer that can be read safely. The
+   * element is as long save to be read until the next extraction is performed.
+   * @return pointer to the element of type T that is the most recent that can be read safely
+   */
+  const T* getNewReadAccessPtr()
+  {
+    bool has_new_data;
+    return getNewReadAccessPtr(has_new_data);
+  }
+
+  /**
+   * @brief Returns a pointer to the most recent element inside the buffer that can be read safely. The
+   * element is as long save to be read until the next extraction is performed.
+   * @param has_new_data The reference is set to true, if a insert operation has been performed since the
+   * last extraction and else it is set to false.
+   * @return pointer to the most recently written element of type T that can be read safely
+   */
+  const T* getNewReadAccessPtr(bool& has_new_data)
+  {
+    has_new_data = takeOverHistory() != 0;
+    return getLastSetReadAccessPtr();
+  }
+
+  /**
+   * @brief Returns the read access pointer that has been set by the last extraction.
+   * @return the last read access pointer that has been set
+   */
+  const T* getLastSetReadAccessPtr() const { return &buffer_[history_[0]].value; }
+
+  /**
+   * @brief Extracts the elements published last, which are as long safe to be read until the next extraction is
+   * performed.
+   * @param history is filled with pointers to the elements published last, the newest first. Only the first entries up
+   * to the returned number are set.
+   * @return number of elements published so far, but at most HISTORY_DEPTH
+   */
+  size_t getHistory(std::array<const T*, HISTORY_DEPTH>& history)
+  {
+    size_t nr_of_new_elements;
+    return getHistory(history, nr_of_new_elements);
+  }
+
+  /**
+   * @brief Extracts the elements published last, which are as long safe to be read until the next extraction is
+   * performed.
+   * @param history is filled with pointers to the elements published last, the newest first. Only the first entries up
+   * to the returned number are set.
+   * @param nr_of_new_elements is set to the number of elements at the front of the history that have been published
+   * since the last extraction. If it equals HISTORY_DEPTH, elements may have been published that are not part of the
+   * history anymore.
+   * @return number of elements published so far, but at most HISTORY_DEPTH
+   */
+  size_t getHistory(std::array<const T*, HISTORY_DEPTH>& history, size_t& nr_of_new_elements)
+  {
+    nr_of_new_elements = takeOverHistory();
+    for (size_t i = 0; i < history_count_; i++)
+    {
+      history[i] = &buffer_[history_[i]].value;
+    }
+    return history_count_;
+  }
+
+private:
+  static constexpr size_t SLOT_COUNT = 2 * HISTORY_DEPTH + 1;
+
+  /* layout of the state word: list of published slots with the newest one in the lowest bits, mask of the slots held by
+   * the reader, number of valid entries in the list and number of elements published since the last extraction */
+  static constexpr unsigned INDEX_BITS = 4;
+  static constexpr uint64_t INDEX_MASK = 0xF;
+  static constexpr uint64_t PUBLISHED_MASK = (uint64_t(1) << (INDEX_BITS * HISTORY_DEPTH)) - 1;
+  static constexpr unsigned HELD_SHIFT = 28;
+  static constexpr uint64_t HELD_MASK = ((uint64_t(1) << SLOT_COUNT) - 1) << HELD_SHIFT;
+  static constexpr unsigned PUBLISHED_COUNT_SHIFT = 43;
+  static constexpr unsigned NEW_COUNT_SHIFT = 46;
+  static constexpr uint64_t COUNT_MASK = 0x7;
+
+  static uint64_t publishedCountOf(uint64_t state) { return (state >> PUBLISHED_COUNT_SHIFT) & COUNT_MASK; }
+  static uint64_t newCountOf(uint64_t state) { return (state >> NEW_COUNT_SHIFT) & COUNT_MASK; }
+  static uint64_t heldMaskOf(uint64_t state) { return (state & HELD_MASK) >> HELD_SHIFT; }
+
+  /* mask of the slots in the list of published slots */
+  static uint64_t slotMaskOf(uint64_t state)
+  {
+    uint64_t mask = 0;
+    for (uint64_t i = 0; i < publishedCountOf(state); i++)
+    {
+      mask |= uint64_t(1) << ((state >> (i * INDEX_BITS)) & INDEX_MASK);
+    }
+    return mask;
+  }
+
+  /* takes the list of published slots over as the slots held by the reader and returns the number of new elements */
+  size_t takeOverHistory()
+  {
+    uint64_t state = state_.load(Ordering::POLL);
+    if (newCountOf(state) == 0)
+    {
+      return 0;
+    }
+    while (!state_.compare_exchange_weak(state, (state & (PUBLISHED_MASK | (COUNT_MASK << PUBLISHED_COUNT_SHIFT))) | (slotMaskOf(state) << HELD_SHIFT),
+                                         Ordering::HANDOVER, Ordering::POLL))
+    {
+    }
+    history_count_ = publishedCountOf(state);
+    for (size_t i = 0; i < history_count_; i++)
+    {
+      history_[i] = (state >> (i * INDEX_BITS)) & INDEX_MASK;
+    }
+    return newCountOf(state);
+  }
+
+  static_assert(SLOT_COUNT <= INDEX_MASK + 1 && HELD_SHIFT >= INDEX_BITS * HISTORY_DEPTH && PUBLISHED_COUNT_SHIFT >= HELD_SHIFT + SLOT_COUNT,
+                "The state does not fit into a single word");
+
+  Slot buffer_[SLOT_COUNT];
+  /* shared by the writer and the reader */
+  alignas(detail::ALIGNMENT_OF<typename Traits::Layout, std::atomic<uint64_t>>) std::atomic<uint64_t> state_;
+
+  /* only accessed by the writer */
+  alignas(Traits::Layout::ALIGNMENT) uint8_t write_slot_ = 1;
+  bool write_in_progress_ = false;
+
+  /* only accessed by the reader */
+  alignas(Traits::Layout::ALIGNMENT) uint8_t history_[HISTORY_DEPTH] = {};
+  size_t history_count_ = 0;
+};
+}  // namespace circular_lifo_buffer
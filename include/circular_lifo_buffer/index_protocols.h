@@ -0,0 +1,280 @@
+//--------------------------------------------------------------------------------------------------------------------------------
+// Copyright 2024 Felix Biemüller, Technische Universität Darmstadt
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation
+// files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED  TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR  PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE
+//--------------------------------------------------------------------------------------------------------------------------------
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include <thread>
+#include <assert.h>
+
+namespace circular_lifo_buffer
+{
+namespace detail
+{
+/**
+ * The original index protocol of the buffer. The index of the slot written last and the index of the slot read at the
+ * moment are kept in two separate atomic variables. As the writer and the reader can not update both of them at once,
+ * the writer has to retry until it found a slot that is neither of them and the reader has to retry until the index
+ * it announced as being read is still the one written last.
+ */
+template <class Traits>
+class RetryLoopIndexProtocol
+{
+public:
+  static const uint8_t SLOT_COUNT = 3;
+
+  RetryLoopIndexProtocol()
+  {
+    last_written_.store(0, std::memory_order_relaxed);
+    current_read_.store(0, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Determines a slot that is neither the last one written nor read at the moment.
+   * @param loop_counter incremented once per iteration of the retry loop
+   * @return index of the slot that can be overwritten by the writer
+   */
+  template <class LoopCounter>
+  uint8_t acquireWriteSlot(LoopCounter& loop_counter)
+  {
+    int current_read_val;
+    int current_write_val;
+    do
+    {
+      loop_counter.increment();
+      next_write_position_ = (next_write_position_ + 1) % SLOT_COUNT;
+      current_read_val = current_read_.load(std::memory_order_seq_cst);
+      current_write_val = last_written_.load(std::memory_order_seq_cst);
+    } while (!(next_write_position_ != current_read_val && next_write_position_ != current_write_val));
+    assert(next_write_position_ >= 0 && next_write_position_ < SLOT_COUNT);
+    return next_write_position_;
+  }
+
+  /**
+   * @brief Marks the slot returned by the last call of acquireWriteSlot() as the one written last.
+   */
+  void publish() { last_written_.store(next_write_position_, std::memory_order_seq_cst); }
+
+  /**
+   * @brief Marks the slot written last as the one read at the moment.
+   * @param is_new_position set to true if the slot has not been read before
+   * @param loop_counter incremented once per iteration of the retry loop
+   * @return index of the slot that can be read
+   */
+  template <class LoopCounter>
+  uint8_t acquireReadSlot(bool& is_new_position, LoopCounter& loop_counter)
+  {
+    uint8_t last_written_ptr;
+    uint8_t old_read_pointer;
+
+    /* The following while loop is critical to ensure that last_written has not changed between the load and exchange
+     * operation otherwise there is a point in time, where last written could have been already changed and current_read
+     * has not changed yet to its new value, so acquireWriteSlot() could select the position which is about to be
+     * stored in current_read.
+     */
+    /* In theory this could lead to read starvation, but as the writer has to write the buffer entry in the mean time
+     * and generate new data to be written, this should be no problem in a practical application.
+     */
+    do
+    {
+      loop_counter.increment();
+      last_written_ptr = last_written_.load(std::memory_order_seq_cst);
+      old_read_pointer = current_read_.exchange(last_written_ptr, std::memory_order_seq_cst);
+    } while (last_written_.load(std::memory_order_seq_cst) != last_written_ptr);
+
+    is_new_position = old_read_pointer != last_written_ptr;
+    return last_written_ptr;
+  }
+
+  bool hasNewData() const { return current_read_.load(Ordering::POLL) != last_written_.load(Ordering::POLL); }
+
+  uint8_t lastReadSlot() const { return current_read_.load(std::memory_order_relaxed); }
+
+private:
+  /* The writer stores last_written_ and loads current_read_ afterwards, while the reader stores current_read_ and loads
+   * last_written_ afterwards. At least one of them has to observe the store of the other one, which is only
+   * guaranteed by sequentially consistent operations. Hence only the polling operations use the configured ordering.
+   */
+  using Ordering = typename Traits::MemoryOrdering;
+  static constexpr size_t ALIGNMENT = Traits::Layout::ALIGNMENT;
+
+  /* written by the writer and read by both threads */
+  alignas(ALIGNMENT) std::atomic<uint8_t> last_written_;
+  /* written by the reader and read by both threads */
+  alignas(ALIGNMENT) std::atomic<uint8_t> current_read_;
+
+  /* only accessed by the writer */
+  alignas(ALIGNMENT) uint8_t next_write_position_ = 0;
+};
+
+/**
+ * Index protocol of a classic triple buffer. The three slots take the roles back (owned by the writer), middle (the
+ * one published last) and front (owned by the reader). Only the index of the middle slot is shared and it is stored
+ * together with a flag indicating whether it has been published since the last read in a single atomic word. Thus
+ * handing a slot over in either direction is one exchange of that word and neither side ever has to retry.
+ */
+template <class Traits>
+class WaitFreeIndexProtocol
+{
+public:
+  static const uint8_t SLOT_COUNT = 3;
+
+  WaitFreeIndexProtocol()
+  {
+    middle_.store(1, std::memory_order_relaxed);
+    back_.store(2, std::memory_order_relaxed);
+    front_.store(0, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief The back slot belongs to the writer exclusively, so no synchronization is required.
+   * @return index of the slot that can be overwritten by the writer
+   */
+  template <class LoopCounter>
+  uint8_t acquireWriteSlot(LoopCounter&)
+  {
+    return back_.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Swaps the back slot with the middle slot and marks it as fresh.
+   */
+  void publish()
+  {
+    back_.store(middle_.exchange(back_.load(std::memory_order_relaxed) | FRESH_BIT, Ordering::HANDOVER) & INDEX_MASK,
+                std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Swaps the front slot with the middle slot, if the middle slot has been published since the last read.
+   * @param is_new_position set to true if the slot has not been read before
+   * @return index of the slot that can be read
+   */
+  template <class LoopCounter>
+  uint8_t acquireReadSlot(bool& is_new_position, LoopCounter&)
+  {
+    /* Only the writer can set the fresh bit, so once it is seen here it remains set until the exchange below. The
+     * exchange does not have to be retried, as a publish in between only replaces the middle slot by a newer one.
+     */
+    is_new_position = (middle_.load(Ordering::POLL) & FRESH_BIT) != 0;
+    if (is_new_position)
+    {
+      front_.store(middle_.exchange(front_.load(std::memory_order_relaxed), Ordering::HANDOVER) & INDEX_MASK, std::memory_order_relaxed);
+    }
+    return front_.load(std::memory_order_relaxed);
+  }
+
+  bool hasNewData() const { return (middle_.load(Ordering::POLL) & FRESH_BIT) != 0; }
+
+  uint8_t lastReadSlot() const { return front_.load(std::memory_order_relaxed); }
+
+  /**
+   * @return index of the slot published last
+   */
+  uint8_t publishedSlot() const { return middle_.load(Ordering::HANDOVER_LOAD) & INDEX_MASK; }
+
+  /**
+   * @brief Repairs the back slot after the writer stopped at an arbitrary point, e.g. because its process died. The
+   * writer and the reader store the slot they got from exchanging the middle slot only after the exchange, so for a
+   * moment both may refer to the middle slot. As the three slots are always a permutation, the slot a side actually
+   * owns is the one that is neither the middle slot nor the one of the other side. A running reader leaves that moment
+   * immediately, so it is waited for. If both sides stopped in that moment, the writer takes the slot after the middle
+   * one and the reader the one before it, so both can recover at the same time.
+   * @param is_reader_stopped function returning true if the reader is not running at the moment
+   * @return index of the slot that belongs to the writer
+   */
+  template <class Predicate>
+  uint8_t recoverWriteSlot(Predicate&& is_reader_stopped)
+  {
+    const uint8_t back = recoverSlot(back_, front_, 1, is_reader_stopped);
+    back_.store(back, std::memory_order_relaxed);
+    return back;
+  }
+
+  /**
+   * @brief Repairs the front slot after the reader stopped at an arbitrary point like recoverWriteSlot().
+   * @param is_writer_stopped function returning true if the writer is not running at the moment
+   * @return index of the slot that belongs to the reader
+   */
+  template <class Predicate>
+  uint8_t recoverReadSlot(Predicate&& is_writer_stopped)
+  {
+    const uint8_t front = recoverSlot(front_, back_, 2, is_writer_stopped);
+    front_.store(front, std::memory_order_relaxed);
+    return front;
+  }
+
+private:
+  using Ordering = typename Traits::MemoryOrdering;
+  static const uint8_t INDEX_MASK = 0x3;
+  static const uint8_t FRESH_BIT = 0x4;
+  static constexpr size_t ALIGNMENT = Traits::Layout::ALIGNMENT;
+
+  template <class Predicate>
+  uint8_t recoverSlot(const std::atomic<uint8_t>& own_slot, const std::atomic<uint8_t>& other_slot, uint8_t offset_if_both_stopped,
+                      Predicate&& is_other_stopped)
+  {
+    while (true)
+    {
+      const uint8_t middle = middle_.load(Ordering::HANDOVER_LOAD) & INDEX_MASK;
+      const uint8_t other = other_slot.load(std::memory_order_relaxed);
+      if (other != middle)
+      {
+        return SLOT_COUNT - middle - other;
+      }
+      if (is_other_stopped())
+      {
+        const uint8_t own = own_slot.load(std::memory_order_relaxed);
+        return own != middle ? own : (middle + offset_if_both_stopped) % SLOT_COUNT;
+      }
+      std::this_thread::yield();
+    }
+  }
+
+  /* shared by both threads */
+  alignas(ALIGNMENT) std::atomic<uint8_t> middle_;
+
+  /* only modified by the writer, atomic as it is read when the reader recovers */
+  alignas(ALIGNMENT) std::atomic<uint8_t> back_;
+  /* only modified by the reader, atomic as it is read when the writer recovers */
+  alignas(ALIGNMENT) std::atomic<uint8_t> front_;
+};
+}  // namespace detail
+
+/**
+ * Selects the original index protocol, which keeps the last written and the currently read slot in two separate atomic
+ * variables. The writer and the reader may have to retry a few times if they access the buffer simultaneously.
+ */
+struct RetryLoopProtocol
+{
+  template <class Traits>
+  using Implementation = detail::RetryLoopIndexProtocol<Traits>;
+};
+
+/**
+ * Selects the triple buffer index protocol, which shares only the index of the slot published last together with a
+ * flag marking it as not read yet in a single atomic word, while the slots held by the writer and the reader are
+ * kept by each of them. getWriteAccessPtr(), indicateWriteDone() and getNewReadAccessPtr() finish with at most one atomic read-modify-write
+ * operation each and never have to retry, so the time they take is bounded independent of the other thread.
+ */
+struct WaitFreeProtocol
+{
+  template <class Traits>
+  using Implementation = detail::WaitFreeIndexProtocol<Traits>;
+};
+}  // namespace circular_lifo_buffer
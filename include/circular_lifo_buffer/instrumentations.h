@@ -0,0 +1,322 @@
+//--------------------------------------------------------------------------------------------------------------------------------
+// Copyright 2024 Felix Biemüller, Technische Universität Darmstadt
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation
+// files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED  TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR  PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE
+//--------------------------------------------------------------------------------------------------------------------------------
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <array>
+#include <atomic>
+#include <chrono>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "circular_lifo_buffer/layouts.h"
+
+namespace circular_lifo_buffer
+{
+/**
+ * Counts of a log-linear histogram. Values below SUB_BUCKET_COUNT have a bucket of their own, while each power of two
+ * above is divided into SUB_BUCKET_COUNT buckets of equal width, so the relative error of a bucket is at most 1/16.
+ * Values of 2^MAX_EXPONENT and above are counted in the last bucket.
+ */
+struct HistogramCounts
+{
+  static constexpr unsigned SUB_BUCKET_BITS = 4;
+  static constexpr uint64_t SUB_BUCKET_COUNT = uint64_t(1) << SUB_BUCKET_BITS;
+  static constexpr unsigned MAX_EXPONENT = 40;
+  static constexpr size_t BUCKET_COUNT = (MAX_EXPONENT - SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT;
+
+  std::array<uint64_t, BUCKET_COUNT> buckets{};
+
+  static size_t bucketOf(uint64_t value)
+  {
+    if (value < SUB_BUCKET_COUNT)
+    {
+      return size_t(value);
+    }
+    const unsigned exponent = 63 - unsigned(__builtin_clzll(value));
+    if (exponent >= MAX_EXPONENT)
+    {
+      return BUCKET_COUNT - 1;
+    }
+    return size_t((exponent - SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT + ((value >> (exponent - SUB_BUCKET_BITS)) - SUB_BUCKET_COUNT));
+  }
+
+  /**
+   * @return smallest value counted in the bucket with the given index
+   */
+  static uint64_t lowerBoundOf(size_t bucket)
+  {
+    if (bucket < SUB_BUCKET_COUNT)
+    {
+      return bucket;
+    }
+    const unsigned exponent = unsigned(bucket / SUB_BUCKET_COUNT) + SUB_BUCKET_BITS - 1;
+    return (SUB_BUCKET_COUNT + bucket % SUB_BUCKET_COUNT) << (exponent - SUB_BUCKET_BITS);
+  }
+
+  uint64_t totalCount() const
+  {
+    uint64_t total = 0;
+    for (uint64_t count : buckets)
+    {
+      total += count;
+    }
+    return total;
+  }
+
+  /**
+   * @param quantile between 0 and 1
+   * @return lower bound of the bucket containing the value at the given quantile, 0 if nothing was counted
+   */
+  uint64_t valueAtQuantile(double quantile) const
+  {
+    const uint64_t total = totalCount();
+    uint64_t remaining = uint64_t(quantile * double(total));
+    for (size_t bucket = 0; bucket < BUCKET_COUNT; bucket++)
+    {
+      if (buckets[bucket] > remaining)
+      {
+        return lowerBoundOf(bucket);
+      }
+      remaining -= buckets[bucket];
+    }
+    return total == 0 ? 0 : lowerBoundOf(highestBucket());
+  }
+
+  /**
+   * @return lower bound of the highest bucket counted, 0 if nothing was counted
+   */
+  uint64_t maxValue() const { return lowerBoundOf(highestBucket()); }
+
+private:
+  size_t highestBucket() const
+  {
+    for (size_t bucket = BUCKET_COUNT; bucket > 0; bucket--)
+    {
+      if (buckets[bucket - 1] != 0)
+      {
+        return bucket - 1;
+      }
+    }
+    return 0;
+  }
+};
+
+/**
+ * Statistics of one operation of the buffer: its duration in timestamp counter cycles and the number of iterations of
+ * its retry loops, which is 0 for operations without a loop.
+ */
+struct OperationStatistics
+{
+  HistogramCounts cycles;
+  HistogramCounts loop_iterations;
+};
+
+/**
+ * Statistics of the operations of the buffer recorded since the last reset.
+ */
+struct InstrumentationSnapshot
+{
+  OperationStatistics get_write_access_ptr;
+  OperationStatistics indicate_write_done;
+  OperationStatistics get_new_read_access_ptr;
+};
+
+namespace detail
+{
+/**
+ * @return timestamp counter of the CPU, which counts at a constant rate on current x86 CPUs, or the nanoseconds of the
+ * steady clock on other architectures
+ */
+inline uint64_t readTimestampCounter()
+{
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+/**
+ * Loop counter passed to the storages, if the instrumentation is disabled. All of its operations compile to nothing.
+ */
+struct NoLoopCount
+{
+  void increment() {}
+};
+
+/**
+ * Loop counter passed to the storages, which is incremented once per iteration of their retry loops.
+ */
+struct LoopCount
+{
+  void increment() { value++; }
+
+  uint64_t value = 0;
+};
+
+/**
+ * Records nothing, so the instrumentation calls in the buffer are removed by the compiler.
+ */
+template <class Traits>
+class NoInstrumentation
+{
+public:
+  using LoopCounter = NoLoopCount;
+
+  struct Timestamp
+  {
+  };
+
+  Timestamp start() const { return {}; }
+  void recordGetWriteAccessPtr(Timestamp, LoopCounter) {}
+  void recordIndicateWriteDone(Timestamp, LoopCounter) {}
+  void recordGetNewReadAccessPtr(Timestamp, LoopCounter) {}
+
+  InstrumentationSnapshot snapshot() const { return {}; }
+  void reset() {}
+};
+
+/**
+ * Records each operation into histograms, which are only written by the thread performing the operation. Their buckets
+ * are atomic, but incremented by a relaxed load and store instead of a read-modify-write operation, so recording costs
+ * two timestamp counter reads and a few non-atomic instructions. Snapshots are taken concurrently to the recording.
+ * Resetting only stores the current counts as baseline of the next snapshots, which is not synchronized, so all calls
+ * of snapshot() and reset() of one buffer have to be made by the same thread. It may be any thread, e.g. the writer,
+ * the reader or a monitoring thread.
+ */
+template <class Traits>
+class HistogramInstrumentation
+{
+public:
+  using LoopCounter = LoopCount;
+  using Timestamp = uint64_t;
+
+  Timestamp start() const { return readTimestampCounter(); }
+  void recordGetWriteAccessPtr(Timestamp start_time, LoopCounter loop_counter) { get_write_access_ptr_.record(start_time, loop_counter); }
+  void recordIndicateWriteDone(Timestamp start_time, LoopCounter loop_counter) { indicate_write_done_.record(start_time, loop_counter); }
+  void recordGetNewReadAccessPtr(Timestamp start_time, LoopCounter loop_counter) { get_new_read_access_ptr_.record(start_time, loop_counter); }
+
+  InstrumentationSnapshot snapshot() const
+  {
+    InstrumentationSnapshot snapshot;
+    load(snapshot);
+    subtract(snapshot.get_write_access_ptr, baseline_.get_write_access_ptr);
+    subtract(snapshot.indicate_write_done, baseline_.indicate_write_done);
+    subtract(snapshot.get_new_read_access_ptr, baseline_.get_new_read_access_ptr);
+    return snapshot;
+  }
+
+  void reset() { load(baseline_); }
+
+private:
+  class AtomicHistogram
+  {
+  public:
+    AtomicHistogram()
+    {
+      for (std::atomic<uint64_t>& bucket : buckets_)
+      {
+        bucket.store(0, std::memory_order_relaxed);
+      }
+    }
+
+    /* only called by the thread owning the histogram */
+    void record(uint64_t value)
+    {
+      std::atomic<uint64_t>& bucket = buckets_[HistogramCounts::bucketOf(value)];
+      bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    void load(HistogramCounts& counts) const
+    {
+      for (size_t bucket = 0; bucket < HistogramCounts::BUCKET_COUNT; bucket++)
+      {
+        counts.buckets[bucket] = buckets_[bucket].load(std::memory_order_relaxed);
+      }
+    }
+
+  private:
+    std::atomic<uint64_t> buckets_[HistogramCounts::BUCKET_COUNT];
+  };
+
+  struct alignas(Traits::Layout::ALIGNMENT) OperationHistograms
+  {
+    void record(Timestamp start_time, LoopCounter loop_counter)
+    {
+      cycles.record(readTimestampCounter() - start_time);
+      loop_iterations.record(loop_counter.value);
+    }
+
+    void load(OperationStatistics& statistics) const
+    {
+      cycles.load(statistics.cycles);
+      loop_iterations.load(statistics.loop_iterations);
+    }
+
+    AtomicHistogram cycles;
+    AtomicHistogram loop_iterations;
+  };
+
+  void load(InstrumentationSnapshot& snapshot) const
+  {
+    get_write_access_ptr_.load(snapshot.get_write_access_ptr);
+    indicate_write_done_.load(snapshot.indicate_write_done);
+    get_new_read_access_ptr_.load(snapshot.get_new_read_access_ptr);
+  }
+
+  static void subtract(OperationStatistics& statistics, const OperationStatistics& baseline)
+  {
+    for (size_t bucket = 0; bucket < HistogramCounts::BUCKET_COUNT; bucket++)
+    {
+      statistics.cycles.buckets[bucket] -= baseline.cycles.buckets[bucket];
+      statistics.loop_iterations.buckets[bucket] -= baseline.loop_iterations.buckets[bucket];
+    }
+  }
+
+  /* recorded by the writer */
+  OperationHistograms get_write_access_ptr_;
+  OperationHistograms indicate_write_done_;
+  /* recorded by the reader */
+  OperationHistograms get_new_read_access_ptr_;
+  /* only accessed by the thread taking the snapshots */
+  alignas(Traits::Layout::ALIGNMENT) InstrumentationSnapshot baseline_;
+};
+}  // namespace detail
+
+/**
+ * Disables the instrumentation, which then costs nothing.
+ */
+struct NoInstrumentation
+{
+  template <class Traits>
+  using Implementation = detail::NoInstrumentation<Traits>;
+};
+
+/**
+ * Records the duration of getWriteAccessPtr(), indicateWriteDone() and getNewReadAccessPtr() in timestamp counter cycles
+ * and the number of iterations of their retry loops into log-linear histograms, see HistogramCounts.
+ */
+struct HistogramInstrumentation
+{
+  template <class Traits>
+  using Implementation = detail::HistogramInstrumentation<Traits>;
+};
+}  // namespace circular_lifo_buffer
@@ -0,0 +1,166 @@
+//--------------------------------------------------------------------------------------------------------------------------------
+// Copyright 2024 Felix Biemüller, Technische Universität Darmstadt
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation
+// files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED  TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR  PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE
+//--------------------------------------------------------------------------------------------------------------------------------
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <algorithm>
+#include <array>
+#include <new>
+#include <stdexcept>
+#include <string>
+
+/**
+ * Size of a cache line in bytes used by the CacheLineIsolatedLayout. std::hardware_destructive_interference_size is not
+ * used directly, as its value may change with the compiler version or the tuning flags, which would change the memory
+ * layout of the buffer between translation units. Define it before including the buffer to use a different value, e.g.
+ * 128 on CPUs that prefetch pairs of cache lines.
+ */
+#ifndef CIRCULAR_LIFO_BUFFER_CACHE_LINE_SIZE
+#define CIRCULAR_LIFO_BUFFER_CACHE_LINE_SIZE 64
+#endif
+
+namespace circular_lifo_buffer
+{
+/**
+ * Places all members of the buffer next to each other, which results in the smallest memory footprint.
+ */
+struct PackedLayout
+{
+  static constexpr size_t ALIGNMENT = 1;
+};
+
+/**
+ * Places the state only accessed by the writer, the state only accessed by the reader, the shared control variables
+ * and each slot on cache lines of their own. This avoids that an access of one thread invalidates the cache line
+ * another thread is working on (false sharing) at the cost of padding, which is significant for small types.
+ */
+struct CacheLineIsolatedLayout
+{
+  static constexpr size_t ALIGNMENT = CIRCULAR_LIFO_BUFFER_CACHE_LINE_SIZE;
+};
+
+namespace detail
+{
+/**
+ * Alignment of a member of type T according to the layout, which is never weaker than the natural alignment of T.
+ */
+template <class Layout, class T>
+constexpr size_t ALIGNMENT_OF = Layout::ALIGNMENT > alignof(T) ? Layout::ALIGNMENT : alignof(T);
+
+/**
+ * Wrapper of a single element of the buffer, which is aligned according to the layout.
+ */
+template <class T, class Layout>
+struct alignas(ALIGNMENT_OF<Layout, T>) Slot
+{
+  T value;
+};
+
+/**
+ * Fixed number of elements, which are aligned according to the layout like a Slot each, but are constructed in place
+ * by a function given to the constructor instead of being default constructed. Thus T does not have to be default
+ * constructible.
+ */
+template <class T, class Layout, size_t SIZE>
+class SlotArray
+{
+public:
+  /**
+   * @param construct_element called with the address of each element, at which it has to construct an object of type
+   * T by placement new. If it throws, the elements constructed before are destroyed.
+   */
+  template <class Constructor>
+  explicit SlotArray(Constructor&& construct_element)
+  {
+    size_t constructed = 0;
+    try
+    {
+      for (; constructed < SIZE; constructed++)
+      {
+        construct_element(static_cast<void*>(slots_[constructed].storage));
+      }
+    }
+    catch (...)
+    {
+      while (constructed > 0)
+      {
+        (*this)[--constructed].~T();
+      }
+      throw;
+    }
+  }
+
+  SlotArray(const SlotArray&) = delete;
+  SlotArray& operator=(const SlotArray&) = delete;
+
+  ~SlotArray()
+  {
+    for (size_t i = 0; i < SIZE; i++)
+    {
+      (*this)[i].~T();
+    }
+  }
+
+  T& operator[](size_t index) { return *std::launder(reinterpret_cast<T*>(slots_[index].storage)); }
+  const T& operator[](size_t index) const { return *std::launder(reinterpret_cast<const T*>(slots_[index].storage)); }
+
+private:
+  struct alignas(ALIGNMENT_OF<Layout, T>) RawSlot
+  {
+    unsigned char storage[sizeof(T)];
+  };
+
+  RawSlot slots_[SIZE];
+};
+
+/**
+ * Fixed number of elements located in memory provided by the user instead of the object, e.g. buffers mapped from a
+ * driver or memory backed by huge pages. The elements have to be constructed by the user and outlive the array, which
+ * neither constructs nor destroys them. Their placement is up to the user, so the Layout is ignored.
+ */
+template <class T, class Layout, size_t SIZE>
+class ExternalSlotArray
+{
+public:
+  /**
+   * @param slots addresses of distinct elements aligned for T
+   * @throw std::invalid_argument if an address is null, not aligned or given twice
+   */
+  explicit ExternalSlotArray(const std::array<T*, SIZE>& slots) : slots_(slots)
+  {
+    for (size_t i = 0; i < SIZE; i++)
+    {
+      if (slots_[i] == nullptr || reinterpret_cast<uintptr_t>(slots_[i]) % alignof(T) != 0 ||
+          std::find(slots_.begin(), slots_.begin() + i, slots_[i]) != slots_.begin() + i)
+      {
+        throw std::invalid_argument("Slot " + std::to_string(i) + " is null, not aligned or given twice");
+      }
+    }
+  }
+
+  ExternalSlotArray(const ExternalSlotArray&) = delete;
+  ExternalSlotArray& operator=(const ExternalSlotArray&) = delete;
+
+  T& operator[](size_t index) { return *slots_[index]; }
+  const T& operator[](size_t index) const { return *slots_[index]; }
+
+private:
+  const std::array<T*, SIZE> slots_;
+};
+}  // namespace detail
+}  // namespace circular_lifo_buffer
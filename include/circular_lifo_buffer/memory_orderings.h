@@ -0,0 +1,56 @@
+//--------------------------------------------------------------------------------------------------------------------------------
+// Copyright 2024 Felix Biemüller, Technische Universität Darmstadt
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation
+// files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED  TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR  PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE
+//--------------------------------------------------------------------------------------------------------------------------------
+
+#pragma once
+
+#include <atomic>
+
+namespace circular_lifo_buffer
+{
+/**
+ * Uses sequentially consistent memory ordering for all atomic operations of the buffer.
+ */
+struct SeqCstOrdering
+{
+  /** ordering of read-modify-write operations handing a slot over from one thread to the other */
+  static constexpr std::memory_order HANDOVER = std::memory_order_seq_cst;
+  /** ordering of loads taking over a slot handed over by another thread */
+  static constexpr std::memory_order HANDOVER_LOAD = std::memory_order_seq_cst;
+  /** ordering of stores handing a slot over to another thread */
+  static constexpr std::memory_order HANDOVER_STORE = std::memory_order_seq_cst;
+  /** ordering of loads that only check whether new data is available without taking over a slot */
+  static constexpr std::memory_order POLL = std::memory_order_seq_cst;
+};
+
+/**
+ * Uses the weakest memory ordering sufficient for the index protocol. Operations handing a slot over are
+ * acquire-release, as they publish the writes to the slot given away and have to observe the accesses of the other
+ * thread to the slot taken over. Loads only checking for new data are relaxed, as the data itself is always taken
+ * over by a subsequent handover operation.
+ *
+ * The WaitFreeProtocol only shares a single atomic word, so all its handover operations are totally ordered by the
+ * modification order of that word and the model in verification/wait_free_buffer_verification.pml covers every
+ * execution allowed by the C++ memory model. The RetryLoopProtocol relies on the total order of sequentially
+ * consistent operations on its two atomic variables, thus only its polling operations are relaxed by this ordering.
+ */
+struct AcquireReleaseOrdering
+{
+  static constexpr std::memory_order HANDOVER = std::memory_order_acq_rel;
+  static constexpr std::memory_order HANDOVER_LOAD = std::memory_order_acquire;
+  static constexpr std::memory_order HANDOVER_STORE = std::memory_order_release;
+  static constexpr std::memory_order POLL = std::memory_order_relaxed;
+};
+}  // namespace circular_lifo_buffer
@@ -0,0 +1,281 @@
+//--------------------------------------------------------------------------------------------------------------------------------
+// Copyright 2024 Felix Biemüller, Technische Universität Darmstadt
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation
+// files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED  TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR  PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE
+//--------------------------------------------------------------------------------------------------------------------------------
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "circular_lifo_buffer/circular_lifo_buffer.h"
+
+namespace circular_lifo_buffer
+{
+/**
+ * This class implements a circular LIFO buffer with several writers and one reader, where the element published last
+ * wins. It is thread safe as long as only one thread extracts elements, while any thread may put elements inside. The
+ * read interface equals the one of CircularLifoBuffer.
+ *
+ * The buffer consists of one lane per writer that may access it at the same time. Each lane is a triple buffer like the
+ * one of the WaitFreeProtocol, whose single atomic word additionally contains the sequence number of the element
+ * published in it. A writer claims a lane that is not used by another writer at the moment, writes its element and
+ * publishes it together with a sequence number taken from a counter shared by all writers. The reader takes over the
+ * elements published in all lanes and returns the one with the highest sequence number, as long as it is higher than
+ * the one of the element returned before. Thus an element that took longer to be published than a newer one is
+ * dropped.
+ * @tparam MAX_CONCURRENT_WRITERS number of lanes, which is the maximum number of writers that can put elements into the
+ * buffer at the same time without waiting for each other
+ * @tparam Traits configuration of the buffer, only the Layout and MemoryOrdering are taken into account
+ */
+template <class T, size_t MAX_CONCURRENT_WRITERS, class Traits = DefaultBufferTraits>
+class MultiWriterLifoBuffer
+{
+  static_assert(MAX_CONCURRENT_WRITERS > 0, "At least one writer has to be allowed");
+
+  using Ordering = typename Traits::MemoryOrdering;
+  using Slot = detail::Slot<T, typename Traits::Layout>;
+
+public:
+  MultiWriterLifoBuffer()
+  {
+    for (Lane& lane : lanes_)
+    {
+      lane.state.store(1, std::memory_order_relaxed);
+      lane.in_use.store(false, std::memory_order_relaxed);
+    }
+    sequence_.store(0, std::memory_order_relaxed);
+  }
+
+  MultiWriterLifoBuffer(const MultiWriterLifoBuffer&) = delete;
+  MultiWriterLifoBuffer& operator=(const MultiWriterLifoBuffer&) = delete;
+
+  /**
+   * @brief This function can be used to setup all elements of the buffer. The given function gets called sequentially
+   * with a reference to each element of the buffer.
+   * @param element_setup_function This setup function gets called with a reference for each element of the buffer
+   */
+  template <class SetupFunction>
+  void setupBufferElements(SetupFunction&& element_setup_function)
+  {
+    for (Lane& lane : lanes_)
+    {
+      for (Slot& slot : lane.slots)
+      {
+        element_setup_function(slot.value);
+      }
+    }
+  }
+
+  /**
+   * @brief Puts a new element into the buffer by calling the given function with a reference to a slot, which is only
+   * accessed by the calling thread until the function returns. Can be called by any thread. If more threads write at
+   * the same time than MAX_CONCURRENT_WRITERS, the additional ones spin until a lane is given back.
+   * @param write_function function taking a reference of type T, which modifies the element to be put inside
+   */
+  template <class WriteFunction>
+  void write(WriteFunction&& write_function)
+  {
+    Lane& lane = claimLane();
+    try
+    {
+      write_function(lane.slots[lane.back].value);
+    }
+    catch (...)
+    {
+      /* the back slot is not published, so only the lane has to be given back */
+      lane.in_use.store(false, Ordering::HANDOVER_STORE);
+      throw;
+    }
+    const uint64_t sequence = sequence_.fetch_add(1, std::memory_order_relaxed) + 1;
+    lane.back = lane.state.exchange(lane.back | FRESH_BIT | (sequence << SEQUENCE_SHIFT), Ordering::HANDOVER) & INDEX_MASK;
+    lane.in_use.store(false, Ordering::HANDOVER_STORE);
+  }
+
+  /**
+   * @brief Puts a new object of type T into the buffer by copying it. Can be called by any thread.
+   * @param new_data The data to be put inside.
+   */
+  void push(const T& new_data)
+  {
+    write([&new_data](T& element) { element = new_data; });
+  }
+
+  /**
+   * @brief Puts a new object of type T into the buffer by moving it. Can be called by any thread.
+   * @param new_data The data to be put inside. It is left in the moved-from state.
+   */
+  void push(T&& new_data)
+  {
+    write([&new_data](T& element) { element = std::move(new_data); });
+  }
+
+  /**
+   * @brief Puts a new object of type T into the buffer, which is constructed directly inside the buffer from the given
+   * arguments. Can be called by any thread.
+   * @param args The arguments forwarded to the constructor of T
+   */
+  template <class... Args>
+  void emplace(Args&&... args)
+  {
+    static_assert(std::is_nothrow_constructible<T, Args...>::value, "Use push() for types whose constructor may throw");
+    write([&args...](T& element) {
+      element.~T();
+      new (&element) T(std::forward<Args>(args)...);
+    });
+  }
+
+  /**
+   * @brief This function can be used to query whether data was put inside the buffer since the last extraction, which
+   * is newer than the element extracted last.
+   * @return true if data has been put inside
+   */
+  bool hasNewData() const
+  {
+    for (const Lane& lane : lanes_)
+    {
+      const uint64_t state = lane.state.load(Ordering::POLL);
+      if ((state & FRESH_BIT) != 0 && (state >> SEQUENCE_SHIFT) > last_sequence_)
+      {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /**
+   * @brief Extracts an element of the buffer in case a new element was put inside it since the last
+   * extraction.
+   * @param target_reference reference to which the element type T should be written to. If no new element have been put
+   * inside the buffer the it is not overwritten.
+   * @return true if a new element was put inside since the last extraction and thus has been extracted
+   */
+  bool popIfNew(T& target_reference)
+  {
+    bool has_new_data;
+    const T* read_location = getNewReadAccessPtr(has_new_data);
+    if (has_new_data)
+    {
+      target_reference = *read_location;
+    }
+    return has_new_data;
+  }
+
+  /**
+   * @brief Extracts the element of the buffer that was written the most recent, no matter whether it has been read
+   * allready.
+   * @param target_reference reference to where the element of type T should be written to.
+   * @return true if a new element was written since the last extraction
+   */
+  bool pop(T& target_reference)
+  {
+    bool has_new_data;
+    const T* read_location = getNewReadAccessPtr(has_new_data);
+    target_reference = *read_location;
+    return has_new_data;
+  }
+
+  /**
+   * @brief Returns a pointer to the most recent element inside the buffer that can be read safely. The
+   * element is as long save to be read until the next extraction is performed.
+   * @return pointer to the element of type T that is the most recent that can be read safely
+   */
+  const T* getNewReadAccessPtr()
+  {
+    bool has_new_data;
+    return getNewReadAccessPtr(has_new_data);
+  }
+
+  /**
+   * @brief Returns a pointer to the most recent element inside the buffer that can be read safely. The
+   * element is as long save to be read until the next extraction is performed.
+   * @param has_new_data The reference is set to true, if an element newer than the one extracted last has been put
+   * inside since the last extraction and else it is set to false.
+   * @return pointer to the most recently written element of type T that can be read safely
+   */
+  const T* getNewReadAccessPtr(bool& has_new_data)
+  {
+    has_new_data = false;
+    for (size_t lane_index = 0; lane_index < MAX_CONCURRENT_WRITERS; lane_index++)
+    {
+      Lane& lane = lanes_[lane_index];
+      if ((lane.state.load(Ordering::POLL) & FRESH_BIT) == 0)
+      {
+        continue;
+      }
+      /* elements of a lane are published with increasing sequence numbers, so the element replaced in the lane read
+       * last is always older than the new one */
+      const uint64_t state = lane.state.exchange(lane.front, Ordering::HANDOVER);
+      lane.front = state & INDEX_MASK;
+      if ((state >> SEQUENCE_SHIFT) > last_sequence_)
+      {
+        last_sequence_ = state >> SEQUENCE_SHIFT;
+        read_lane_ = lane_index;
+        has_new_data = true;
+      }
+    }
+    return &lanes_[read_lane_].slots[lanes_[read_lane_].front].value;
+  }
+
+  /**
+   * @brief Returns the read access pointer that has been set by the last extraction.
+   * @return the last read access pointer that has been set
+   */
+  const T* getLastSetReadAccessPtr() const { return &lanes_[read_lane_].slots[lanes_[read_lane_].front].value; }
+
+private:
+  static constexpr uint64_t INDEX_MASK = 0x3;
+  static constexpr uint64_t FRESH_BIT = 0x4;
+  static constexpr unsigned SEQUENCE_SHIFT = 3;
+
+  struct Lane
+  {
+    Slot slots[3];
+    /* index of the middle slot, fresh bit and sequence number of the middle slot */
+    alignas(detail::ALIGNMENT_OF<typename Traits::Layout, std::atomic<uint64_t>>) std::atomic<uint64_t> state;
+    /* claimed by a writer, which then owns the back slot */
+    alignas(detail::ALIGNMENT_OF<typename Traits::Layout, std::atomic<bool>>) std::atomic<bool> in_use;
+    uint8_t back = 2;
+    /* only accessed by the reader */
+    alignas(Traits::Layout::ALIGNMENT) uint8_t front = 0;
+  };
+
+  Lane& claimLane()
+  {
+    /* start with the lane used last by this thread, which is most likely free */
+    thread_local size_t lane_hint = 0;
+    for (size_t attempt = 0;; attempt++)
+    {
+      Lane& lane = lanes_[(lane_hint + attempt) % MAX_CONCURRENT_WRITERS];
+      if (!lane.in_use.load(std::memory_order_relaxed) && !lane.in_use.exchange(true, Ordering::HANDOVER))
+      {
+        lane_hint = (lane_hint + attempt) % MAX_CONCURRENT_WRITERS;
+        return lane;
+      }
+    }
+  }
+
+  Lane lanes_[MAX_CONCURRENT_WRITERS];
+  /* shared by all writers */
+  alignas(detail::ALIGNMENT_OF<typename Traits::Layout, std::atomic<uint64_t>>) std::atomic<uint64_t> sequence_;
+
+  /* only accessed by the reader */
+  alignas(Traits::Layout::ALIGNMENT) uint64_t last_sequence_ = 0;
+  size_t read_lane_ = 0;
+};
+}  // namespace circular_lifo_buffer
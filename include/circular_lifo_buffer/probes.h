@@ -0,0 +1,45 @@
+//--------------------------------------------------------------------------------------------------------------------------------
+// Copyright 2024 Felix Biemüller, Technische Universität Darmstadt
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation
+// files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED  TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR  PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE
+//--------------------------------------------------------------------------------------------------------------------------------
+
+#pragma once
+
+/**
+ * Static tracepoints (USDT) of the buffer, which are compiled in if <sys/sdt.h> is available, e.g. by installing
+ * systemtap-sdt-dev, and can be disabled by defining CIRCULAR_LIFO_BUFFER_DISABLE_PROBES. A probe that is not attached
+ * is a single nop instruction, and its arguments are only read from registers or memory when a tracer like perf or
+ * bpftrace attaches to it. All probes belong to the provider circular_lifo_buffer and have the arguments buffer
+ * address, slot index and sequence number:
+ * - write_acquire: getWriteAccessPtr() returns the slot the element will be published in
+ * - write_publish: indicateWriteDone() starts publishing the element
+ * - read_acquire: the reader extracted the element in the slot, whose sequence number only changes for new elements
+ */
+#if !defined(CIRCULAR_LIFO_BUFFER_DISABLE_PROBES) && defined(__has_include)
+#if __has_include(<sys/sdt.h>)
+#include <sys/sdt.h>
+#define CIRCULAR_LIFO_BUFFER_PROBES_ENABLED
+#endif
+#endif
+
+#ifdef CIRCULAR_LIFO_BUFFER_PROBES_ENABLED
+#define CIRCULAR_LIFO_BUFFER_PROBE(name, buffer, slot, sequence_number)                                                   \
+  DTRACE_PROBE3(circular_lifo_buffer, name, static_cast<const void*>(buffer), static_cast<unsigned>(slot),               \
+                static_cast<unsigned long long>(sequence_number))
+#else
+#define CIRCULAR_LIFO_BUFFER_PROBE(name, buffer, slot, sequence_number)                                                   \
+  do                                                                                                                     \
+  {                                                                                                                      \
+  } while (false)
+#endif
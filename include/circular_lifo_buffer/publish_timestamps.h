@@ -0,0 +1,85 @@
+//--------------------------------------------------------------------------------------------------------------------------------
+// Copyright 2024 Felix Biemüller, Technische Universität Darmstadt
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation
+// files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED  TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR  PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE
+//--------------------------------------------------------------------------------------------------------------------------------
+
+#pragma once
+
+#include <stdint.h>
+#include <chrono>
+
+namespace circular_lifo_buffer
+{
+namespace detail
+{
+/**
+ * Clock of the storages if no publish timestamps are recorded. Its timestamp is empty, so it is removed by the
+ * compiler.
+ */
+template <class Traits>
+struct NoPublishClock
+{
+  static constexpr bool ENABLED = false;
+
+  struct Timestamp
+  {
+  };
+
+  static Timestamp now() { return {}; }
+};
+
+/**
+ * Clock of the storages recording the time of each publish with the steady clock, which is comparable between threads.
+ */
+template <class Traits>
+struct SteadyPublishClock
+{
+  static constexpr bool ENABLED = true;
+
+  using Timestamp = std::chrono::steady_clock::time_point;
+
+  static Timestamp now() { return std::chrono::steady_clock::now(); }
+};
+
+/**
+ * Number and time of the publish operation that put an element inside, which the storages keep for each slot.
+ */
+template <class Timestamp>
+struct PublishRecord
+{
+  uint64_t sequence_number = 0;
+  Timestamp publish_time{};
+};
+}  // namespace detail
+
+/**
+ * Records no publish timestamps, so neither the writer nor the reader reads a clock.
+ */
+struct NoPublishTimestamps
+{
+  template <class Traits>
+  using Implementation = detail::NoPublishClock<Traits>;
+};
+
+/**
+ * Stores the time of the publish operation together with each element, so the reader can query how long it took until
+ * an element was visible and how old the element it uses is. Costs one read of the steady clock per publish and per
+ * new element extracted.
+ */
+struct SteadyClockPublishTimestamps
+{
+  template <class Traits>
+  using Implementation = detail::SteadyPublishClock<Traits>;
+};
+}  // namespace circular_lifo_buffer
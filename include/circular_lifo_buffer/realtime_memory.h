@@ -0,0 +1,390 @@
+//--------------------------------------------------------------------------------------------------------------------------------
+// Copyright 2024 Felix Biemüller, Technische Universität Darmstadt
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation
+// files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED  TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR  PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE
+//--------------------------------------------------------------------------------------------------------------------------------
+
+#pragma once
+
+#include <stddef.h>
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <array>
+#include <new>
+#include <system_error>
+
+#include <errno.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include "circular_lifo_buffer/layouts.h"
+
+namespace circular_lifo_buffer
+{
+/**
+ * Kind of pages backing a RealtimeMemory.
+ */
+enum class HugePages
+{
+  /** pages of the regular size */
+  NONE,
+  /** regular pages the kernel is advised to merge into transparent huge pages, which falls back silently, e.g. if they
+   * are disabled or no free huge page is available, see RealtimeMemory::hugePageBytes() */
+  TRANSPARENT,
+  /** pages from the pool of explicit huge pages (hugetlbfs), which has to be reserved by the administrator */
+  EXPLICIT
+};
+
+namespace detail
+{
+inline size_t pageSize() { return size_t(sysconf(_SC_PAGESIZE)); }
+
+/**
+ * @return size of the default huge pages as reported by the kernel, 2 MiB if it is not reported
+ */
+inline size_t hugePageSize()
+{
+  static const size_t huge_page_size = []() {
+    size_t size_in_kib = 2048;
+    if (FILE* const meminfo = fopen("/proc/meminfo", "r"))
+    {
+      char line[128];
+      while (fgets(line, sizeof(line), meminfo) != nullptr && sscanf(line, "Hugepagesize: %zu kB", &size_in_kib) != 1)
+      {
+      }
+      fclose(meminfo);
+    }
+    return size_in_kib * 1024;
+  }();
+  return huge_page_size;
+}
+}  // namespace detail
+
+/**
+ * @brief Touches every page of the given range by writing back a byte of it, so the page faults of the first access
+ * happen now instead of e.g. in the first push() of a real-time loop. Must not be called while other threads access the
+ * range. Optionally locks the pages in memory, so they are never swapped out or migrated afterwards.
+ * @param address start of the range, e.g. the address of a buffer
+ * @param size size of the range in bytes
+ * @param lock whether to lock the pages by mlock()
+ * @throw std::system_error if the pages can not be locked, e.g. because RLIMIT_MEMLOCK is too low
+ */
+inline void prefaultMemory(void* address, size_t size, bool lock = true)
+{
+  const size_t page_size = detail::pageSize();
+  const uintptr_t begin = reinterpret_cast<uintptr_t>(address) / page_size * page_size;
+  const uintptr_t end = reinterpret_cast<uintptr_t>(address) + size;
+  if (lock && mlock(reinterpret_cast<void*>(begin), end - begin) != 0)
+  {
+    throw std::system_error(errno, std::generic_category(), "Could not lock memory");
+  }
+  for (uintptr_t page = begin; page < end; page += page_size)
+  {
+    /* the first byte of the first page may be outside of the range */
+    volatile unsigned char* const byte = reinterpret_cast<volatile unsigned char*>(page < uintptr_t(address) ? uintptr_t(address) : page);
+    *byte = *byte;
+  }
+}
+
+/**
+ * Anonymous memory prepared for real-time use: it is optionally backed by huge pages, which need fewer TLB entries,
+ * locked in memory and prefaulted completely on construction, so accessing it never causes a page fault. Combined with
+ * RealtimeSlots and the ExternalSlotsStrategy, it holds the slots of a buffer.
+ */
+class RealtimeMemory
+{
+public:
+  /**
+   * @param size minimum size in bytes, which is rounded up to a multiple of the huge page size unless they are not used
+   * @param huge_pages kind of pages backing the memory
+   * @param lock whether to lock the memory by mlock()
+   * @throw std::system_error if the memory can not be mapped, e.g. because no explicit huge pages are reserved, or can
+   * not be locked, e.g. because RLIMIT_MEMLOCK is too low
+   */
+  explicit RealtimeMemory(size_t size, HugePages huge_pages = HugePages::TRANSPARENT, bool lock = true)
+    : huge_pages_(huge_pages), is_locked_(lock)
+  {
+    const size_t page_size = huge_pages == HugePages::NONE ? detail::pageSize() : detail::hugePageSize();
+    size_ = (size + page_size - 1) / page_size * page_size;
+    if (size_ == 0)
+    {
+      size_ = page_size;
+    }
+    /* transparent huge pages are only used by faults after the advice, so the mapping is not populated right away.
+     * They also have to be aligned to their size, which the kernel does not guarantee for the start of a mapping, so
+     * one huge page more is mapped and the unaligned parts at both ends are unmapped again */
+    const int flags = huge_pages == HugePages::TRANSPARENT ? 0 : huge_pages == HugePages::EXPLICIT ? MAP_POPULATE | MAP_HUGETLB : MAP_POPULATE;
+    const size_t mapped_size = huge_pages == HugePages::TRANSPARENT ? size_ + page_size : size_;
+    data_ = mmap(nullptr, mapped_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | flags, -1, 0);
+    if (data_ == MAP_FAILED)
+    {
+      throw std::system_error(errno, std::generic_category(), "Could not map real-time memory");
+    }
+    if (huge_pages == HugePages::TRANSPARENT)
+    {
+      const uintptr_t begin = reinterpret_cast<uintptr_t>(data_);
+      const uintptr_t aligned_begin = (begin + page_size - 1) / page_size * page_size;
+      if (aligned_begin != begin)
+      {
+        munmap(data_, aligned_begin - begin);
+      }
+      if (aligned_begin + size_ != begin + mapped_size)
+      {
+        munmap(reinterpret_cast<void*>(aligned_begin + size_), begin + mapped_size - aligned_begin - size_);
+      }
+      data_ = reinterpret_cast<void*>(aligned_begin);
+      /* only a hint, the memory is usable without transparent huge pages as well */
+      madvise(data_, size_, MADV_HUGEPAGE);
+    }
+    try
+    {
+      prefaultMemory(data_, size_, lock);
+    }
+    catch (...)
+    {
+      munmap(data_, size_);
+      throw;
+    }
+  }
+
+  RealtimeMemory(RealtimeMemory&& other) noexcept
+    : data_(other.data_), size_(other.size_), huge_pages_(other.huge_pages_), is_locked_(other.is_locked_)
+  {
+    other.data_ = nullptr;
+    other.size_ = 0;
+  }
+
+  RealtimeMemory(const RealtimeMemory&) = delete;
+  RealtimeMemory& operator=(const RealtimeMemory&) = delete;
+  RealtimeMemory& operator=(RealtimeMemory&&) = delete;
+
+  /**
+   * @brief Unmaps the memory, which also unlocks it.
+   */
+  ~RealtimeMemory()
+  {
+    if (data_ != nullptr)
+    {
+      munmap(data_, size_);
+    }
+  }
+
+  void* data() const { return data_; }
+
+  /**
+   * @return size in bytes after rounding up to the page size
+   */
+  size_t size() const { return size_; }
+
+  HugePages hugePages() const { return huge_pages_; }
+
+  bool isLocked() const { return is_locked_; }
+
+  /**
+   * @brief Reads the size of the huge pages backing the memory from /proc/self/smaps, e.g. to check whether transparent
+   * huge pages are used. The kernel may merge the mapping with an adjacent one of the same kind, whose huge pages are
+   * included then.
+   * @return size in bytes of the huge pages backing the mapping that contains the memory, 0 if it can not be read
+   */
+  size_t hugePageBytes() const
+  {
+    size_t size_in_kib = 0;
+    if (FILE* const smaps = fopen("/proc/self/smaps", "r"))
+    {
+      const uintptr_t address = reinterpret_cast<uintptr_t>(data_);
+      bool is_inside = false;
+      char line[512];
+      while (fgets(line, sizeof(line), smaps) != nullptr)
+      {
+        uintptr_t begin;
+        uintptr_t end;
+        size_t field_in_kib;
+        if (sscanf(line, "%" SCNxPTR "-%" SCNxPTR, &begin, &end) == 2)
+        {
+          if (is_inside)
+          {
+            break;
+          }
+          is_inside = begin <= address && address < end;
+        }
+        else if (is_inside && (sscanf(line, "AnonHugePages: %zu kB", &field_in_kib) == 1 ||
+                               sscanf(line, "Private_Hugetlb: %zu kB", &field_in_kib) == 1))
+        {
+          size_in_kib += field_in_kib;
+        }
+      }
+      fclose(smaps);
+    }
+    return size_in_kib * 1024;
+  }
+
+private:
+  void* data_;
+  size_t size_;
+  HugePages huge_pages_;
+  bool is_locked_;
+};
+
+/**
+ * Three elements in a RealtimeMemory, each on cache lines of its own, which serve as the slots of a CircularLifoBuffer
+ * with the ExternalSlotsStrategy, e.g.
+ * @code
+ * RealtimeSlots<Frame> slots(HugePages::TRANSPARENT);
+ * CircularLifoBuffer<Frame, ExternalSlotsTraits> buffer(slots.slots());
+ * @endcode
+ * Memory allocated by the elements themselves, e.g. by containers, is not covered, which mlockall() does.
+ */
+template <class T>
+class RealtimeSlots
+{
+public:
+  static constexpr size_t SLOT_COUNT = 3;
+
+  /**
+   * @param huge_pages kind of pages backing the slots
+   * @param lock whether to lock the memory by mlock()
+   * @param args arguments passed to the constructor of each element, which are never moved from
+   * @throw std::system_error if the memory can not be mapped or locked
+   */
+  template <class... Args>
+  explicit RealtimeSlots(HugePages huge_pages = HugePages::TRANSPARENT, bool lock = true, const Args&... args)
+    : memory_(SLOT_COUNT * STRIDE, huge_pages, lock)
+  {
+    size_t constructed = 0;
+    try
+    {
+      for (; constructed < SLOT_COUNT; constructed++)
+      {
+        slots_[constructed] = new (static_cast<char*>(memory_.data()) + constructed * STRIDE) T(args...);
+      }
+    }
+    catch (...)
+    {
+      while (constructed > 0)
+      {
+        slots_[--constructed]->~T();
+      }
+      throw;
+    }
+  }
+
+  RealtimeSlots(const RealtimeSlots&) = delete;
+  RealtimeSlots& operator=(const RealtimeSlots&) = delete;
+
+  ~RealtimeSlots()
+  {
+    for (T* const slot : slots_)
+    {
+      slot->~T();
+    }
+  }
+
+  /**
+   * @return addresses of the elements, which are passed to the constructor of the CircularLifoBuffer
+   */
+  const std::array<T*, SLOT_COUNT>& slots() const { return slots_; }
+
+  const RealtimeMemory& memory() const { return memory_; }
+
+private:
+  static constexpr size_t SLOT_ALIGNMENT = alignof(T) > CacheLineIsolatedLayout::ALIGNMENT ? alignof(T) : CacheLineIsolatedLayout::ALIGNMENT;
+  static constexpr size_t STRIDE = (sizeof(T) + SLOT_ALIGNMENT - 1) / SLOT_ALIGNMENT * SLOT_ALIGNMENT;
+
+  RealtimeMemory memory_;
+  std::array<T*, SLOT_COUNT> slots_;
+};
+
+/**
+ * Number of page faults, either minor ones, which only map a page, or major ones, which have to read it from disk.
+ */
+struct PageFaultCounts
+{
+  uint64_t minor = 0;
+  uint64_t major = 0;
+
+  /**
+   * @return page faults of the calling thread since it started
+   * @throw std::system_error if they can not be queried
+   */
+  static PageFaultCounts ofThread()
+  {
+    rusage usage;
+    if (getrusage(RUSAGE_THREAD, &usage) != 0)
+    {
+      throw std::system_error(errno, std::generic_category(), "Could not query page faults");
+    }
+    return PageFaultCounts{ uint64_t(usage.ru_minflt), uint64_t(usage.ru_majflt) };
+  }
+
+  uint64_t total() const { return minor + major; }
+
+  PageFaultCounts operator-(const PageFaultCounts& other) const { return PageFaultCounts{ minor - other.minor, major - other.major }; }
+};
+
+/**
+ * Page faults of a thread during its warm-up and afterwards, see PageFaultMonitor.
+ */
+struct PageFaultReport
+{
+  PageFaultCounts during_warm_up;
+  PageFaultCounts after_warm_up;
+};
+
+/**
+ * Counts the page faults of the calling thread, e.g. of a real-time loop, in order to verify that none happen once it
+ * is warmed up, e.g.
+ * @code
+ * PageFaultMonitor monitor;
+ * runCycles(10);
+ * monitor.endWarmUp();
+ * runCycles(10000);
+ * assert(monitor.report().after_warm_up.total() == 0);
+ * @endcode
+ * Must only be used by the thread that constructed it, as the counts are taken per thread.
+ */
+class PageFaultMonitor
+{
+public:
+  PageFaultMonitor() : start_(PageFaultCounts::ofThread()), warm_up_end_(start_) {}
+
+  /**
+   * @brief Marks the end of the warm-up, the faults from now on are reported as after_warm_up.
+   */
+  void endWarmUp()
+  {
+    warm_up_end_ = PageFaultCounts::ofThread();
+    is_warmed_up_ = true;
+  }
+
+  /**
+   * @return faults since the construction until endWarmUp() and since then, all of them count as during the warm-up as
+   * long as endWarmUp() has not been called
+   */
+  PageFaultReport report() const
+  {
+    const PageFaultCounts now = PageFaultCounts::ofThread();
+    if (!is_warmed_up_)
+    {
+      return PageFaultReport{ now - start_, PageFaultCounts() };
+    }
+    return PageFaultReport{ warm_up_end_ - start_, now - warm_up_end_ };
+  }
+
+private:
+  PageFaultCounts start_;
+  PageFaultCounts warm_up_end_;
+  bool is_warmed_up_ = false;
+};
+}  // namespace circular_lifo_buffer
@@ -0,0 +1,551 @@
+//--------------------------------------------------------------------------------------------------------------------------------
+// Copyright 2024 Felix Biemüller, Technische Universität Darmstadt
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation
+// files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED  TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR  PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE
+//--------------------------------------------------------------------------------------------------------------------------------
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <atomic>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <typeinfo>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "circular_lifo_buffer/circular_lifo_buffer.h"
+
+namespace circular_lifo_buffer
+{
+/**
+ * Registration of the process that writes or reads a buffer in shared memory, see SharedMemoryLifoBuffer::claimWriter().
+ */
+struct SharedMemoryOwner
+{
+  /** process id of the owner, 0 if there is none and negative while the owner recovers the state left by its predecessor */
+  std::atomic<int32_t> pid;
+  /** incremented whenever a process registers, so the other side can detect a restart */
+  std::atomic<uint32_t> epoch;
+};
+
+/**
+ * Header at the beginning of the shared memory region of a SharedMemoryLifoBuffer, which describes its layout. A process
+ * attaching to the region checks it against the layout it expects, so buffers of different types, configurations or
+ * versions of this library are not mixed up. It only contains offsets and sizes, no pointers, and the registration of
+ * the processes writing and reading.
+ */
+struct SharedMemoryHeader
+{
+  /** "LIFOBUF" followed by a zero byte, stored last by the creating process once the region is initialized */
+  static constexpr uint64_t MAGIC = 0x004655424f46494cull;
+  /** incremented whenever the layout of the region changes */
+  static constexpr uint32_t LAYOUT_VERSION = 3;
+
+  std::atomic<uint64_t> magic;
+  uint32_t layout_version;
+  uint32_t header_size;
+  uint64_t element_size;
+  uint64_t element_alignment;
+  /** hash of the buffer type including its element type and configuration, see SharedMemoryLifoBuffer::typeHash() */
+  uint64_t type_hash;
+  /** offset of the buffer from the beginning of the region */
+  uint64_t buffer_offset;
+  uint64_t buffer_size;
+  uint64_t region_size;
+  SharedMemoryOwner writer;
+  SharedMemoryOwner reader;
+};
+
+namespace detail
+{
+/**
+ * 64 bit FNV-1a hash of a null terminated string, used to compare types across processes by their mangled names.
+ */
+inline uint64_t hashName(const char* name)
+{
+  uint64_t hash = 0xcbf29ce484222325ull;
+  for (; *name != '\0'; name++)
+  {
+    hash = (hash ^ uint8_t(*name)) * 0x100000001b3ull;
+  }
+  return hash;
+}
+
+/**
+ * @return whether the process of the given id, which may be negated, exists. A process counts as dead once kill() does
+ * not find it anymore, so a parent has to reap a dead child first.
+ */
+inline bool isProcessAlive(int32_t pid)
+{
+  return kill(pid < 0 ? -pid : pid, 0) == 0 || errno == EPERM;
+}
+
+/**
+ * Message sent together with the file descriptor of a region by SharedMemoryLifoBuffer::send(), which the receiving
+ * process checks before mapping it.
+ */
+struct SharedMemoryHandOff
+{
+  uint64_t magic;
+  uint32_t layout_version;
+  uint32_t reserved;
+  uint64_t type_hash;
+  uint64_t region_size;
+};
+
+/**
+ * Configuration of the buffer inside the shared memory. The wait-free triple buffer contains no pointers and keeps the
+ * slot owned by each side inside the region, while the polling wait does not depend on process private futexes.
+ */
+template <class Traits>
+struct SharedMemoryTraits : Traits
+{
+  using Strategy = TripleBufferStrategy;
+  using IndexProtocol = WaitFreeProtocol;
+  using WaitStrategy = PollingWait;
+};
+}  // namespace detail
+
+/**
+ * This class places a CircularLifoBuffer into a POSIX shared memory object or an anonymous memory file (memfd), so one
+ * process can write and another process can read it. Each process maps the region on its own, so it is located at
+ * different addresses. Thus the region consists of a SharedMemoryHeader followed by the buffer, which is found by its
+ * offset and contains no pointers itself. Once mapped, the buffer is accessed through buffer() with the same cost as a
+ * CircularLifoBuffer within one process.
+ *
+ * One process creates the region by create() or createAnonymous(), which constructs the buffer, while the other one
+ * attaches to it by attach(). As in a single process, only one process may write and only one may read.
+ *
+ * The buffer survives the processes using it. If they register by claimWriter() and claimReader(), a process replacing
+ * one that died recovers the state it left behind, even if it died in the middle of an operation, and resumes after a
+ * bounded number of steps without ever publishing or reading a torn element.
+ * @tparam T trivially copyable type, as the elements are accessed by several processes
+ * @tparam Traits configuration of the buffer, only the Layout, MemoryOrdering, Instrumentation and PublishTimestamps
+ * are taken into account
+ */
+template <class T, class Traits = DefaultBufferTraits>
+class SharedMemoryLifoBuffer
+{
+  static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable types can be shared between processes");
+  static_assert(std::atomic<uint64_t>::is_always_lock_free, "Atomics in shared memory have to be lock-free");
+
+public:
+  using Buffer = CircularLifoBuffer<T, detail::SharedMemoryTraits<Traits>>;
+
+  /**
+   * @brief Creates a new POSIX shared memory object and constructs the buffer inside it.
+   * @param name name of the shared memory object, starting with a slash, e.g. "/joint_states"
+   * @throw std::system_error if the object already exists or can not be created
+   */
+  static SharedMemoryLifoBuffer create(const std::string& name)
+  {
+    const int file_descriptor = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (file_descriptor < 0)
+    {
+      throw std::system_error(errno, std::generic_category(), "Could not create shared memory object " + name);
+    }
+    try
+    {
+      return initialize(file_descriptor);
+    }
+    catch (...)
+    {
+      shm_unlink(name.c_str());
+      throw;
+    }
+  }
+
+  /**
+   * @brief Creates an anonymous memory file, which is only accessible through its file descriptor, and constructs the
+   * buffer inside it. The file descriptor can be inherited by a child process or sent to another process by send(). Its
+   * size is sealed, so no process can shrink it below the mapping of another one.
+   * @param name name of the memory file, which is only used for debugging
+   * @throw std::system_error if the memory file can not be created
+   */
+  static SharedMemoryLifoBuffer createAnonymous(const std::string& name = "circular_lifo_buffer")
+  {
+    const int file_descriptor = memfd_create(name.c_str(), MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (file_descriptor < 0)
+    {
+      throw std::system_error(errno, std::generic_category(), "Could not create memory file " + name);
+    }
+    SharedMemoryLifoBuffer shared_buffer = initialize(file_descriptor);
+    if (fcntl(file_descriptor, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL) != 0)
+    {
+      throw std::system_error(errno, std::generic_category(), "Could not seal the size of memory file " + name);
+    }
+    return shared_buffer;
+  }
+
+  /**
+   * @brief Receives the file descriptor of a region sent by send() over a Unix domain socket and maps it, so processes
+   * that can not open shared memory objects by name, e.g. due to a sandbox, exchange data without copying. The type of
+   * the buffer and the size of the region are checked before mapping, the header of the region afterwards.
+   * @param socket connected Unix domain socket, which blocks until the message arrives unless it is non-blocking
+   * @throw std::system_error if receiving fails
+   * @throw std::runtime_error if the message contains no file descriptor or a buffer of a different type or layout
+   */
+  static SharedMemoryLifoBuffer receive(int socket)
+  {
+    detail::SharedMemoryHandOff hand_off;
+    iovec payload{ &hand_off, sizeof(hand_off) };
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int))];
+    msghdr message{};
+    message.msg_iov = &payload;
+    message.msg_iovlen = 1;
+    message.msg_control = control;
+    message.msg_controllen = sizeof(control);
+
+    ssize_t received = recvmsg(socket, &message, MSG_CMSG_CLOEXEC);
+    if (received < 0)
+    {
+      throw std::system_error(errno, std::generic_category(), "Could not receive shared memory");
+    }
+    const cmsghdr* const control_message = CMSG_FIRSTHDR(&message);
+    if (control_message == nullptr || control_message->cmsg_level != SOL_SOCKET || control_message->cmsg_type != SCM_RIGHTS ||
+        control_message->cmsg_len != CMSG_LEN(sizeof(int)))
+    {
+      throw std::runtime_error("Received message contains no file descriptor of shared memory");
+    }
+    int file_descriptor;
+    memcpy(&file_descriptor, CMSG_DATA(control_message), sizeof(int));
+
+    /* a stream socket may deliver the rest of the message later, while the file descriptor comes with its first byte */
+    while (received > 0 && size_t(received) < sizeof(hand_off))
+    {
+      const ssize_t rest = recv(socket, reinterpret_cast<char*>(&hand_off) + received, sizeof(hand_off) - size_t(received), 0);
+      received = rest > 0 ? received + rest : rest;
+    }
+    if (size_t(received) != sizeof(hand_off) || (message.msg_flags & MSG_CTRUNC) != 0 || hand_off.magic != SharedMemoryHeader::MAGIC ||
+        hand_off.layout_version != SharedMemoryHeader::LAYOUT_VERSION || hand_off.type_hash != typeHash() ||
+        hand_off.region_size != REGION_SIZE)
+    {
+      close(file_descriptor);
+      throw std::runtime_error("Received shared memory contains a buffer of a different element type or configuration");
+    }
+    return map(file_descriptor);
+  }
+
+  /**
+   * @brief Attaches to the buffer in a POSIX shared memory object created by create().
+   * @param name name of the shared memory object
+   * @throw std::system_error if the object can not be opened
+   * @throw std::runtime_error if the object is not initialized yet or contains a buffer of a different layout
+   */
+  static SharedMemoryLifoBuffer attach(const std::string& name)
+  {
+    const int file_descriptor = shm_open(name.c_str(), O_RDWR, 0);
+    if (file_descriptor < 0)
+    {
+      throw std::system_error(errno, std::generic_category(), "Could not open shared memory object " + name);
+    }
+    return map(file_descriptor);
+  }
+
+  /**
+   * @brief Attaches to the buffer in the shared memory object or memory file referred to by the file descriptor, which
+   * is duplicated, so the caller keeps the ownership of it.
+   * @throw std::system_error if the file descriptor is invalid
+   * @throw std::runtime_error if the region is not initialized yet or contains a buffer of a different layout
+   */
+  static SharedMemoryLifoBuffer attach(int file_descriptor)
+  {
+    const int duplicate = fcntl(file_descriptor, F_DUPFD_CLOEXEC, 0);
+    if (duplicate < 0)
+    {
+      throw std::system_error(errno, std::generic_category(), "Could not duplicate file descriptor");
+    }
+    return map(duplicate);
+  }
+
+  /**
+   * @brief Removes the name of a POSIX shared memory object. Processes that mapped it keep their mapping.
+   */
+  static void unlink(const std::string& name) { shm_unlink(name.c_str()); }
+
+  /**
+   * @return hash of the mangled name of the buffer type, which includes the element type and the configuration, so all
+   * processes comparing it have to be built with compatible compilers
+   */
+  static uint64_t typeHash() { return detail::hashName(typeid(Buffer).name()); }
+
+  SharedMemoryLifoBuffer(SharedMemoryLifoBuffer&& other) noexcept
+    : file_descriptor_(other.file_descriptor_), region_(other.region_), owner_(other.owner_)
+  {
+    other.file_descriptor_ = -1;
+    other.region_ = nullptr;
+    other.owner_ = nullptr;
+  }
+
+  SharedMemoryLifoBuffer& operator=(SharedMemoryLifoBuffer&& other) noexcept
+  {
+    if (this != &other)
+    {
+      release();
+      file_descriptor_ = other.file_descriptor_;
+      region_ = other.region_;
+      owner_ = other.owner_;
+      other.file_descriptor_ = -1;
+      other.region_ = nullptr;
+      other.owner_ = nullptr;
+    }
+    return *this;
+  }
+
+  SharedMemoryLifoBuffer(const SharedMemoryLifoBuffer&) = delete;
+  SharedMemoryLifoBuffer& operator=(const SharedMemoryLifoBuffer&) = delete;
+
+  /**
+   * @brief Ends the registration as writer or reader and unmaps the region, but does not destroy the buffer, which may
+   * still be used by the other process.
+   */
+  ~SharedMemoryLifoBuffer() { release(); }
+
+  /**
+   * @return the buffer inside the shared memory region, which provides the interface of CircularLifoBuffer
+   */
+  Buffer& buffer() { return *reinterpret_cast<Buffer*>(static_cast<char*>(region_) + BUFFER_OFFSET); }
+  Buffer* operator->() { return &buffer(); }
+
+  const SharedMemoryHeader& header() const { return *static_cast<const SharedMemoryHeader*>(region_); }
+
+  /**
+   * @return file descriptor of the shared memory object or memory file, which stays owned by this object
+   */
+  int fileDescriptor() const { return file_descriptor_; }
+
+  /**
+   * @brief Sends the file descriptor of the region together with a description of the buffer over a Unix domain socket
+   * to another process, which maps it by receive(). This object keeps its own mapping.
+   * @param socket connected Unix domain socket
+   * @throw std::system_error if sending fails
+   */
+  void send(int socket) const
+  {
+    detail::SharedMemoryHandOff hand_off{ SharedMemoryHeader::MAGIC, SharedMemoryHeader::LAYOUT_VERSION, 0, typeHash(), REGION_SIZE };
+    iovec payload{ &hand_off, sizeof(hand_off) };
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int))] = {};
+    msghdr message{};
+    message.msg_iov = &payload;
+    message.msg_iovlen = 1;
+    message.msg_control = control;
+    message.msg_controllen = sizeof(control);
+    cmsghdr* const control_message = CMSG_FIRSTHDR(&message);
+    control_message->cmsg_level = SOL_SOCKET;
+    control_message->cmsg_type = SCM_RIGHTS;
+    control_message->cmsg_len = CMSG_LEN(sizeof(int));
+    memcpy(CMSG_DATA(control_message), &file_descriptor_, sizeof(int));
+
+    if (sendmsg(socket, &message, MSG_NOSIGNAL) != ssize_t(sizeof(hand_off)))
+    {
+      throw std::system_error(errno, std::generic_category(), "Could not send shared memory");
+    }
+  }
+
+  /**
+   * @brief Registers the calling process as the writer of the buffer until this object is destroyed. If the process
+   * registered before died without unregistering, e.g. in between getWriteAccessPtr() and indicateWriteDone(), the
+   * state it left behind is repaired by CircularLifoBuffer::recoverWriter(), while the reader may continue. A process
+   * counts as dead once kill() does not find it anymore, so a parent has to reap a dead child first.
+   * @return epoch of the writer, which is incremented by every registration
+   * @throw std::runtime_error if a process that is alive is registered as the writer or this object is registered already
+   */
+  uint32_t claimWriter()
+  {
+    return claim(mutableHeader().writer, header().reader, "writer", [this](auto&& is_reader_stopped) { buffer().recoverWriter(is_reader_stopped); });
+  }
+
+  /**
+   * @brief Registers the calling process as the reader of the buffer like claimWriter(), the state left behind by a
+   * reader that died is repaired by CircularLifoBuffer::recoverReader().
+   * @return epoch of the reader, which is incremented by every registration
+   * @throw std::runtime_error if a process that is alive is registered as the reader or this object is registered already
+   */
+  uint32_t claimReader()
+  {
+    return claim(mutableHeader().reader, header().writer, "reader", [this](auto&& is_writer_stopped) { buffer().recoverReader(is_writer_stopped); });
+  }
+
+  /**
+   * @return number of processes that registered as writer so far, e.g. for the reader to detect that the writer restarted
+   */
+  uint32_t writerEpoch() const { return header().writer.epoch.load(std::memory_order_acquire); }
+
+  /**
+   * @return number of processes that registered as reader so far
+   */
+  uint32_t readerEpoch() const { return header().reader.epoch.load(std::memory_order_acquire); }
+
+private:
+  static constexpr size_t BUFFER_OFFSET = (sizeof(SharedMemoryHeader) + alignof(Buffer) - 1) / alignof(Buffer) * alignof(Buffer);
+  static constexpr size_t REGION_SIZE = BUFFER_OFFSET + sizeof(Buffer);
+
+  SharedMemoryHeader& mutableHeader() { return *static_cast<SharedMemoryHeader*>(region_); }
+
+  SharedMemoryLifoBuffer(int file_descriptor, void* region) : file_descriptor_(file_descriptor), region_(region), owner_(nullptr) {}
+
+  /* takes the ownership of the file descriptor, which refers to an empty file */
+  static SharedMemoryLifoBuffer initialize(int file_descriptor)
+  {
+    if (ftruncate(file_descriptor, off_t(REGION_SIZE)) != 0)
+    {
+      const int error = errno;
+      close(file_descriptor);
+      throw std::system_error(error, std::generic_category(), "Could not resize shared memory");
+    }
+    SharedMemoryLifoBuffer shared_buffer(file_descriptor, mapRegion(file_descriptor, REGION_SIZE));
+
+    SharedMemoryHeader* const header = new (shared_buffer.region_) SharedMemoryHeader();
+    header->magic.store(0, std::memory_order_relaxed);
+    header->layout_version = SharedMemoryHeader::LAYOUT_VERSION;
+    header->header_size = sizeof(SharedMemoryHeader);
+    header->element_size = sizeof(T);
+    header->element_alignment = alignof(T);
+    header->type_hash = typeHash();
+    header->buffer_offset = BUFFER_OFFSET;
+    header->buffer_size = sizeof(Buffer);
+    header->region_size = REGION_SIZE;
+    for (SharedMemoryOwner* owner : { &header->writer, &header->reader })
+    {
+      owner->pid.store(0, std::memory_order_relaxed);
+      owner->epoch.store(0, std::memory_order_relaxed);
+    }
+    new (static_cast<char*>(shared_buffer.region_) + BUFFER_OFFSET) Buffer();
+    /* a process attaching concurrently only accesses the buffer after it has seen the magic number */
+    header->magic.store(SharedMemoryHeader::MAGIC, std::memory_order_release);
+    return shared_buffer;
+  }
+
+  /* takes the ownership of the file descriptor, which refers to an initialized region */
+  static SharedMemoryLifoBuffer map(int file_descriptor)
+  {
+    struct stat status;
+    if (fstat(file_descriptor, &status) != 0)
+    {
+      const int error = errno;
+      close(file_descriptor);
+      throw std::system_error(error, std::generic_category(), "Could not query the size of the shared memory");
+    }
+    if (size_t(status.st_size) != REGION_SIZE)
+    {
+      close(file_descriptor);
+      throw std::runtime_error("Shared memory has a size of " + std::to_string(status.st_size) + " bytes instead of " +
+                               std::to_string(REGION_SIZE) + ", it is not initialized or contains a different buffer");
+    }
+    SharedMemoryLifoBuffer shared_buffer(file_descriptor, mapRegion(file_descriptor, REGION_SIZE));
+    shared_buffer.checkHeader();
+    return shared_buffer;
+  }
+
+  /* closes the file descriptor if the region can not be mapped */
+  static void* mapRegion(int file_descriptor, size_t size)
+  {
+    void* const region = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, file_descriptor, 0);
+    if (region == MAP_FAILED)
+    {
+      const int error = errno;
+      close(file_descriptor);
+      throw std::system_error(error, std::generic_category(), "Could not map shared memory");
+    }
+    return region;
+  }
+
+  void checkHeader() const
+  {
+    const SharedMemoryHeader& expected = header();
+    if (expected.magic.load(std::memory_order_acquire) != SharedMemoryHeader::MAGIC)
+    {
+      throw std::runtime_error("Shared memory does not contain an initialized buffer");
+    }
+    if (expected.layout_version != SharedMemoryHeader::LAYOUT_VERSION)
+    {
+      throw std::runtime_error("Shared memory has layout version " + std::to_string(expected.layout_version) + " instead of " +
+                               std::to_string(SharedMemoryHeader::LAYOUT_VERSION));
+    }
+    if (expected.header_size != sizeof(SharedMemoryHeader) || expected.element_size != sizeof(T) || expected.element_alignment != alignof(T) ||
+        expected.type_hash != typeHash() || expected.buffer_offset != BUFFER_OFFSET || expected.buffer_size != sizeof(Buffer) || expected.region_size != REGION_SIZE)
+    {
+      throw std::runtime_error("Shared memory contains a buffer of a different element type or configuration");
+    }
+  }
+
+  /* the registration is taken over by a compare exchange, so only one of several processes replacing a dead owner
+   * recovers its state, during which the id is negative to mark the side as not running for the other side */
+  template <class Recovery>
+  uint32_t claim(SharedMemoryOwner& owner, const SharedMemoryOwner& other, const char* role, Recovery&& recover)
+  {
+    if (owner_ != nullptr)
+    {
+      throw std::runtime_error("Shared memory buffer is registered as writer or reader already");
+    }
+    const int32_t pid = int32_t(getpid());
+    int32_t previous_pid = owner.pid.load(std::memory_order_acquire);
+    do
+    {
+      if (previous_pid != 0 && detail::isProcessAlive(previous_pid))
+      {
+        throw std::runtime_error(std::string("Process ") + std::to_string(previous_pid < 0 ? -previous_pid : previous_pid) +
+                                 " is registered as " + role + " of the shared memory buffer");
+      }
+    } while (!owner.pid.compare_exchange_weak(previous_pid, -pid, std::memory_order_acq_rel, std::memory_order_acquire));
+
+    if (previous_pid != 0)
+    {
+      recover([&other] {
+        const int32_t other_pid = other.pid.load(std::memory_order_acquire);
+        return other_pid <= 0 || !detail::isProcessAlive(other_pid);
+      });
+    }
+    const uint32_t epoch = owner.epoch.fetch_add(1, std::memory_order_relaxed) + 1;
+    owner.pid.store(pid, std::memory_order_release);
+    owner_ = &owner;
+    return epoch;
+  }
+
+  void release()
+  {
+    if (owner_ != nullptr)
+    {
+      owner_->pid.store(0, std::memory_order_release);
+      owner_ = nullptr;
+    }
+    if (region_ != nullptr)
+    {
+      munmap(region_, REGION_SIZE);
+      region_ = nullptr;
+    }
+    if (file_descriptor_ >= 0)
+    {
+      close(file_descriptor_);
+      file_descriptor_ = -1;
+    }
+  }
+
+  int file_descriptor_;
+  void* region_;
+  /* registration of this object inside the header, if any */
+  SharedMemoryOwner* owner_;
+};
+}  // namespace circular_lifo_buffer
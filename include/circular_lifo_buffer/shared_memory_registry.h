@@ -0,0 +1,465 @@
+//--------------------------------------------------------------------------------------------------------------------------------
+// Copyright 2024 Felix Biemüller, Technische Universität Darmstadt
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation
+// files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED  TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR  PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE
+//--------------------------------------------------------------------------------------------------------------------------------
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "circular_lifo_buffer/shared_memory_lifo_buffer.h"
+
+namespace circular_lifo_buffer
+{
+/**
+ * Entry of a SharedMemoryRegistry describing one buffer, which is stored in a shared memory object of its own.
+ */
+struct SharedMemoryRegistryEntry
+{
+  static constexpr size_t NAME_CAPACITY = 64;
+
+  static constexpr uint32_t FREE = 0;
+  /** taken by a process that is filling in the entry */
+  static constexpr uint32_t RESERVED = 1;
+  static constexpr uint32_t READY = 2;
+  /** taken by a process that filled in the name and creates the shared memory object of the buffer */
+  static constexpr uint32_t CREATING = 3;
+
+  /** one of the states above in the lowest byte, a generation incremented by every reservation in the next three bytes
+   * and the id of the process that reserved the entry in the upper half, so an entry reserved by a process that died
+   * is taken over and a reader detects that the entry was reused while it copied it. The name is only valid while the
+   * state is CREATING or READY, the other fields only while it is READY, which is stored last */
+  std::atomic<uint64_t> state;
+  /** null terminated name of the buffer */
+  char name[NAME_CAPACITY];
+  /** hash of the type of the buffer including its element type and configuration */
+  uint64_t type_hash;
+  uint64_t element_size;
+  uint64_t buffer_size;
+
+  static uint64_t makeState(uint32_t state, uint32_t generation, int32_t pid)
+  {
+    return uint64_t(state) | uint64_t(generation & 0xffffff) << 8 | uint64_t(uint32_t(pid)) << 32;
+  }
+  static uint32_t stateOf(uint64_t state) { return uint32_t(state & 0xff); }
+  static uint32_t generationOf(uint64_t state) { return uint32_t(state >> 8) & 0xffffff; }
+  static int32_t ownerOf(uint64_t state) { return int32_t(uint32_t(state >> 32)); }
+};
+
+/**
+ * Table at the beginning of the shared memory object of a SharedMemoryRegistry. A zero filled region is a valid empty
+ * table once the magic number is set, so any process may create it.
+ */
+struct SharedMemoryRegistryTable
+{
+  /** "LIFOREG" followed by a zero byte */
+  static constexpr uint64_t MAGIC = 0x004745524f46494cull;
+  /** stored in place of the magic number together with the id of the process that initializes the region in the upper
+   * half, so another process takes over if it dies in between */
+  static constexpr uint64_t INITIALIZING = 1;
+  /** incremented whenever the layout of the table changes */
+  static constexpr uint32_t LAYOUT_VERSION = 2;
+  static constexpr size_t ENTRY_CAPACITY = 256;
+
+  std::atomic<uint64_t> magic;
+  uint32_t layout_version;
+  uint32_t entry_capacity;
+  SharedMemoryRegistryEntry entries[ENTRY_CAPACITY];
+
+  static uint64_t initializingBy(int32_t pid) { return INITIALIZING | uint64_t(uint32_t(pid)) << 32; }
+  static bool isInitializing(uint64_t magic) { return (magic & 0xffffffff) == INITIALIZING; }
+  static int32_t initializerOf(uint64_t magic) { return int32_t(uint32_t(magic >> 32)); }
+};
+
+/**
+ * This class is a directory in shared memory, which maps names like "joint_states" to SharedMemoryLifoBuffers, so
+ * processes find the buffers they exchange data with by name instead of agreeing on the names of shared memory objects.
+ * Each buffer is stored in a shared memory object of its own, whose name consists of the name of the registry followed
+ * by a dot and the name of the buffer. The registry stores the sizes of the buffer and its element as well as a hash of
+ * its type, which are checked when a process attaches, so buffers of different types with the same size are not mixed
+ * up. It is only used when a buffer is created or attached, e.g. at the start of a process, while the buffers returned
+ * are accessed directly afterwards.
+ *
+ * The registry is created by the first process opening it. Entries are taken and released by atomic operations, so
+ * several processes can register buffers concurrently. A process that dies while it initializes the registry or
+ * registers a buffer does not block the others: the entry it reserved is taken over by the next registration and the
+ * shared memory object it may have created is removed by the next registration of the same name. Like the registrations
+ * of SharedMemoryLifoBuffer, a process counts as dead once kill() does not find it anymore. The type hashes are those of
+ * SharedMemoryLifoBuffer::typeHash().
+ */
+class SharedMemoryRegistry
+{
+public:
+  static constexpr const char* DEFAULT_NAME = "/circular_lifo_buffer_registry";
+
+  /**
+   * @brief Opens the registry of the given name and creates it if it does not exist yet.
+   * @param name name of the shared memory object of the registry, starting with a slash
+   * @throw std::system_error if the object can not be opened or created
+   * @throw std::runtime_error if the object contains no registry of this version
+   */
+  static SharedMemoryRegistry open(const std::string& name = DEFAULT_NAME)
+  {
+    const int file_descriptor = shm_open(name.c_str(), O_RDWR | O_CREAT, 0600);
+    if (file_descriptor < 0)
+    {
+      throw std::system_error(errno, std::generic_category(), "Could not open shared memory registry " + name);
+    }
+    SharedMemoryRegistry registry(name, file_descriptor);
+    registry.mapTable();
+    return registry;
+  }
+
+  /**
+   * @brief Removes the registry of the given name, but not the buffers registered in it. Processes that opened it keep
+   * their mapping.
+   */
+  static void unlink(const std::string& name = DEFAULT_NAME) { shm_unlink(name.c_str()); }
+
+  SharedMemoryRegistry(SharedMemoryRegistry&& other) noexcept
+    : name_(std::move(other.name_)), file_descriptor_(other.file_descriptor_), table_(other.table_)
+  {
+    other.file_descriptor_ = -1;
+    other.table_ = nullptr;
+  }
+
+  SharedMemoryRegistry& operator=(SharedMemoryRegistry&& other) noexcept
+  {
+    if (this != &other)
+    {
+      release();
+      name_ = std::move(other.name_);
+      file_descriptor_ = other.file_descriptor_;
+      table_ = other.table_;
+      other.file_descriptor_ = -1;
+      other.table_ = nullptr;
+    }
+    return *this;
+  }
+
+  SharedMemoryRegistry(const SharedMemoryRegistry&) = delete;
+  SharedMemoryRegistry& operator=(const SharedMemoryRegistry&) = delete;
+
+  ~SharedMemoryRegistry() { release(); }
+
+  /**
+   * @brief Creates a buffer by SharedMemoryLifoBuffer::create() and registers it under the given name.
+   * @param buffer_name name of the buffer, which must not contain a slash
+   * @throw std::invalid_argument if the name is empty, too long or contains a slash
+   * @throw std::runtime_error if a buffer of this name is registered already or the registry is full
+   * @throw std::system_error if the shared memory object of the buffer can not be created
+   */
+  template <class T, class Traits = DefaultBufferTraits>
+  SharedMemoryLifoBuffer<T, Traits> create(const std::string& buffer_name)
+  {
+    checkName(buffer_name);
+    EntryCopy registered;
+    if (find(buffer_name, registered) != nullptr)
+    {
+      throw std::runtime_error("Buffer " + buffer_name + " is registered already in " + name_);
+    }
+    uint64_t state;
+    SharedMemoryRegistryEntry* const entry = reserveEntry(buffer_name, state);
+    const uint32_t generation = SharedMemoryRegistryEntry::generationOf(state);
+    try
+    {
+      auto shared_buffer = createObject<T, Traits>(buffer_name, entry);
+      entry->type_hash = SharedMemoryLifoBuffer<T, Traits>::typeHash();
+      entry->element_size = sizeof(T);
+      entry->buffer_size = sizeof(typename SharedMemoryLifoBuffer<T, Traits>::Buffer);
+      entry->state.store(SharedMemoryRegistryEntry::makeState(SharedMemoryRegistryEntry::READY, generation, int32_t(getpid())),
+                         std::memory_order_release);
+      return shared_buffer;
+    }
+    catch (...)
+    {
+      entry->state.store(SharedMemoryRegistryEntry::makeState(SharedMemoryRegistryEntry::FREE, generation, 0), std::memory_order_release);
+      throw;
+    }
+  }
+
+  /**
+   * @brief Attaches to the buffer registered under the given name by SharedMemoryLifoBuffer::attach().
+   * @throw std::runtime_error if no buffer of this name is registered or it has a different type or configuration
+   * @throw std::system_error if the shared memory object of the buffer can not be opened
+   */
+  template <class T, class Traits = DefaultBufferTraits>
+  SharedMemoryLifoBuffer<T, Traits> attach(const std::string& buffer_name) const
+  {
+    EntryCopy entry;
+    if (find(buffer_name, entry) == nullptr)
+    {
+      throw std::runtime_error("No buffer " + buffer_name + " is registered in " + name_);
+    }
+    if (entry.element_size != sizeof(T) || entry.buffer_size != sizeof(typename SharedMemoryLifoBuffer<T, Traits>::Buffer) ||
+        entry.type_hash != SharedMemoryLifoBuffer<T, Traits>::typeHash())
+    {
+      throw std::runtime_error("Buffer " + buffer_name + " is registered with a different element type or configuration");
+    }
+    return SharedMemoryLifoBuffer<T, Traits>::attach(objectName(buffer_name));
+  }
+
+  /**
+   * @brief Removes the buffer registered under the given name from the registry and unlinks its shared memory object.
+   * Processes that attached to it keep their mapping.
+   * @return false if no buffer of this name is registered
+   */
+  bool remove(const std::string& buffer_name)
+  {
+    EntryCopy registered;
+    SharedMemoryRegistryEntry* const entry = find(buffer_name, registered);
+    if (entry == nullptr)
+    {
+      return false;
+    }
+    shm_unlink(objectName(buffer_name).c_str());
+    uint64_t state = registered.state;
+    return entry->state.compare_exchange_strong(
+        state, SharedMemoryRegistryEntry::makeState(SharedMemoryRegistryEntry::FREE, SharedMemoryRegistryEntry::generationOf(state), 0),
+        std::memory_order_acq_rel);
+  }
+
+  /**
+   * @return names of all buffers registered at the moment
+   */
+  std::vector<std::string> names() const
+  {
+    std::vector<std::string> buffer_names;
+    for (const SharedMemoryRegistryEntry& entry : table_->entries)
+    {
+      EntryCopy copy;
+      if (copyEntry(entry, copy) && SharedMemoryRegistryEntry::stateOf(copy.state) == SharedMemoryRegistryEntry::READY)
+      {
+        buffer_names.emplace_back(copy.name);
+      }
+    }
+    return buffer_names;
+  }
+
+  /**
+   * @return name of the shared memory object the buffer registered under the given name is stored in
+   */
+  std::string objectName(const std::string& buffer_name) const { return name_ + "." + buffer_name; }
+
+  const std::string& name() const { return name_; }
+
+private:
+  static constexpr size_t REGION_SIZE = sizeof(SharedMemoryRegistryTable);
+
+  /* copy of an entry taken like the payload of a seqlock, so it is consistent even if the entry is reused meanwhile */
+  struct EntryCopy
+  {
+    uint64_t state;
+    char name[SharedMemoryRegistryEntry::NAME_CAPACITY];
+    uint64_t type_hash;
+    uint64_t element_size;
+    uint64_t buffer_size;
+  };
+
+  SharedMemoryRegistry(const std::string& name, int file_descriptor) : name_(name), file_descriptor_(file_descriptor), table_(nullptr) {}
+
+  /* a new object has a size of zero, while resizing an object to the same size keeps its content, so all processes
+   * opening it concurrently can resize it, while only one sets the magic number */
+  void mapTable()
+  {
+    struct stat status;
+    if (fstat(file_descriptor_, &status) != 0 || (status.st_size == 0 && ftruncate(file_descriptor_, off_t(REGION_SIZE)) != 0))
+    {
+      throw std::system_error(errno, std::generic_category(), "Could not resize shared memory registry " + name_);
+    }
+    if (status.st_size != 0 && size_t(status.st_size) != REGION_SIZE)
+    {
+      throw std::runtime_error("Shared memory registry " + name_ + " has a size of " + std::to_string(status.st_size) +
+                               " bytes instead of " + std::to_string(REGION_SIZE));
+    }
+    void* const region = mmap(nullptr, REGION_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, file_descriptor_, 0);
+    if (region == MAP_FAILED)
+    {
+      throw std::system_error(errno, std::generic_category(), "Could not map shared memory registry " + name_);
+    }
+    table_ = static_cast<SharedMemoryRegistryTable*>(region);
+
+    /* the creating process only stores two fields in between, which another process stores again if it died */
+    uint64_t magic = table_->magic.load(std::memory_order_acquire);
+    while (magic == 0 || SharedMemoryRegistryTable::isInitializing(magic))
+    {
+      if ((magic == 0 || !detail::isProcessAlive(SharedMemoryRegistryTable::initializerOf(magic))) &&
+          table_->magic.compare_exchange_strong(magic, SharedMemoryRegistryTable::initializingBy(int32_t(getpid())), std::memory_order_acquire))
+      {
+        table_->layout_version = SharedMemoryRegistryTable::LAYOUT_VERSION;
+        table_->entry_capacity = SharedMemoryRegistryTable::ENTRY_CAPACITY;
+        magic = SharedMemoryRegistryTable::MAGIC;
+        table_->magic.store(magic, std::memory_order_release);
+        break;
+      }
+      std::this_thread::yield();
+      magic = table_->magic.load(std::memory_order_acquire);
+    }
+    if (magic != SharedMemoryRegistryTable::MAGIC || table_->layout_version != SharedMemoryRegistryTable::LAYOUT_VERSION ||
+        table_->entry_capacity != SharedMemoryRegistryTable::ENTRY_CAPACITY)
+    {
+      throw std::runtime_error("Shared memory " + name_ + " contains no registry of layout version " +
+                               std::to_string(SharedMemoryRegistryTable::LAYOUT_VERSION));
+    }
+  }
+
+  static void checkName(const std::string& buffer_name)
+  {
+    if (buffer_name.empty() || buffer_name.size() >= SharedMemoryRegistryEntry::NAME_CAPACITY ||
+        buffer_name.find('/') != std::string::npos)
+    {
+      throw std::invalid_argument("Invalid buffer name \"" + buffer_name + "\", it has to consist of 1 to " +
+                                  std::to_string(SharedMemoryRegistryEntry::NAME_CAPACITY - 1) + " characters except a slash");
+    }
+  }
+
+  /* the state is loaded again after the fields were copied, a different value means that they may be torn. The state
+   * is loaded sequentially consistent, which isNameTaken() relies on */
+  static bool copyEntry(const SharedMemoryRegistryEntry& entry, EntryCopy& copy)
+  {
+    copy.state = entry.state.load(std::memory_order_seq_cst);
+    const uint32_t state = SharedMemoryRegistryEntry::stateOf(copy.state);
+    if (state != SharedMemoryRegistryEntry::READY && state != SharedMemoryRegistryEntry::CREATING)
+    {
+      return false;
+    }
+    memcpy(copy.name, entry.name, sizeof(copy.name));
+    copy.name[sizeof(copy.name) - 1] = '\0';
+    copy.type_hash = entry.type_hash;
+    copy.element_size = entry.element_size;
+    copy.buffer_size = entry.buffer_size;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return entry.state.load(std::memory_order_relaxed) == copy.state;
+  }
+
+  SharedMemoryRegistryEntry* find(const std::string& buffer_name, EntryCopy& copy) const
+  {
+    for (SharedMemoryRegistryEntry& entry : table_->entries)
+    {
+      if (copyEntry(entry, copy) && SharedMemoryRegistryEntry::stateOf(copy.state) == SharedMemoryRegistryEntry::READY &&
+          buffer_name == copy.name)
+      {
+        return &entry;
+      }
+    }
+    return nullptr;
+  }
+
+  /* whether another entry than the given one registers the name or is about to create its shared memory object */
+  bool isNameTaken(const std::string& buffer_name, const SharedMemoryRegistryEntry* own_entry) const
+  {
+    for (const SharedMemoryRegistryEntry& entry : table_->entries)
+    {
+      EntryCopy copy;
+      if (&entry != own_entry && copyEntry(entry, copy) && buffer_name == copy.name &&
+          (SharedMemoryRegistryEntry::stateOf(copy.state) == SharedMemoryRegistryEntry::READY ||
+           detail::isProcessAlive(SharedMemoryRegistryEntry::ownerOf(copy.state))))
+      {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /* the shared memory object is created exclusively, so only one of several processes registering the same name
+   * concurrently succeeds. An object that exists already without being registered was left behind by a process that
+   * died in between, it is replaced unless another process registering the name is alive. As each process announces
+   * the name by its entry before it creates the object and checks the other entries afterwards, at most one of them
+   * replaces the object */
+  template <class T, class Traits>
+  SharedMemoryLifoBuffer<T, Traits> createObject(const std::string& buffer_name, const SharedMemoryRegistryEntry* entry)
+  {
+    try
+    {
+      return SharedMemoryLifoBuffer<T, Traits>::create(objectName(buffer_name));
+    }
+    catch (const std::system_error& error)
+    {
+      if (error.code() != std::errc::file_exists)
+      {
+        throw;
+      }
+    }
+    if (isNameTaken(buffer_name, entry))
+    {
+      throw std::runtime_error("Buffer " + buffer_name + " is registered already in " + name_);
+    }
+    shm_unlink(objectName(buffer_name).c_str());
+    return SharedMemoryLifoBuffer<T, Traits>::create(objectName(buffer_name));
+  }
+
+  /* takes a free entry or one reserved by a process that died before its buffer was ready and announces the name */
+  SharedMemoryRegistryEntry* reserveEntry(const std::string& buffer_name, uint64_t& state)
+  {
+    const int32_t pid = int32_t(getpid());
+    for (SharedMemoryRegistryEntry& entry : table_->entries)
+    {
+      uint64_t previous = entry.state.load(std::memory_order_acquire);
+      const uint32_t previous_state = SharedMemoryRegistryEntry::stateOf(previous);
+      if (previous_state == SharedMemoryRegistryEntry::READY ||
+          (previous_state != SharedMemoryRegistryEntry::FREE && detail::isProcessAlive(SharedMemoryRegistryEntry::ownerOf(previous))))
+      {
+        continue;
+      }
+      const uint32_t generation = SharedMemoryRegistryEntry::generationOf(previous) + 1;
+      if (entry.state.compare_exchange_strong(previous, SharedMemoryRegistryEntry::makeState(SharedMemoryRegistryEntry::RESERVED, generation, pid),
+                                              std::memory_order_acq_rel))
+      {
+        /* readers copying the entry detect the name being overwritten by the reserved state like in a seqlock */
+        std::atomic_thread_fence(std::memory_order_release);
+        buffer_name.copy(entry.name, buffer_name.size());
+        entry.name[buffer_name.size()] = '\0';
+        state = SharedMemoryRegistryEntry::makeState(SharedMemoryRegistryEntry::CREATING, generation, pid);
+        entry.state.store(state, std::memory_order_seq_cst);
+        return &entry;
+      }
+    }
+    throw std::runtime_error("Shared memory registry " + name_ + " is full, it holds at most " +
+                             std::to_string(SharedMemoryRegistryTable::ENTRY_CAPACITY) + " buffers");
+  }
+
+  void release()
+  {
+    if (table_ != nullptr)
+    {
+      munmap(table_, REGION_SIZE);
+      table_ = nullptr;
+    }
+    if (file_descriptor_ >= 0)
+    {
+      close(file_descriptor_);
+      file_descriptor_ = -1;
+    }
+  }
+
+  std::string name_;
+  int file_descriptor_;
+  SharedMemoryRegistryTable* table_;
+};
+}  // namespace circular_lifo_buffer
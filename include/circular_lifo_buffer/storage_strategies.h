@@ -0,0 +1,601 @@
+//--------------------------------------------------------------------------------------------------------------------------------
+// Copyright 2024 Felix Biemüller, Technische Universität Darmstadt
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation
+// files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED  TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR  PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE
+//--------------------------------------------------------------------------------------------------------------------------------
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <atomic>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+#include "circular_lifo_buffer/layouts.h"
+#include "circular_lifo_buffer/publish_timestamps.h"
+
+/**
+ * Maximum size in bytes of a trivially copyable type for which the AutomaticStrategy selects the SeqlockStrategy. Larger
+ * types are put into a triple buffer, as the time the reader may have to retry grows with the size of the type.
+ */
+#ifndef CIRCULAR_LIFO_BUFFER_SEQLOCK_MAX_SIZE
+#define CIRCULAR_LIFO_BUFFER_SEQLOCK_MAX_SIZE 64
+#endif
+
+namespace circular_lifo_buffer
+{
+namespace detail
+{
+/**
+ * Stores the elements in the slots of a triple buffer, whose assignment to the writer and the reader is determined by
+ * the IndexProtocol of the Traits. Every element is accessed in place, so any type can be stored.
+ * @tparam Slots array of the elements, either SlotArray holding them inside the storage or ExternalSlotArray
+ */
+template <class T, class Traits, template <class, class, size_t> class Slots = SlotArray>
+class TripleBufferStorage
+{
+  using IndexProtocol = typename Traits::IndexProtocol::template Implementation<Traits>;
+  using Clock = typename Traits::PublishTimestamps::template Implementation<Traits>;
+
+public:
+  using Record = detail::PublishRecord<typename Clock::Timestamp>;
+
+  /**
+   * @param construct_element called with the address of each slot, at which it constructs an element by placement new,
+   * or the addresses of the elements in case of an ExternalSlotArray
+   */
+  template <class Constructor>
+  explicit TripleBufferStorage(Constructor&& construct_element) : buffer_(construct_element)
+  {
+  }
+
+  template <class SetupFunction>
+  void setup(SetupFunction&& element_setup_function)
+  {
+    for (uint8_t slot = 0; slot < BUFFER_SIZE; slot++)
+    {
+      element_setup_function(buffer_[slot]);
+    }
+  }
+
+  /**
+   * @param loop_counter incremented once per iteration of a retry loop, see LoopCount
+   * @return location of the element the writer is allowed to modify until publish() is called
+   */
+  template <class LoopCounter>
+  T* acquireWriteLocation(LoopCounter& loop_counter)
+  {
+    write_slot_ = index_protocol_.acquireWriteSlot(loop_counter);
+    return &buffer_[write_slot_];
+  }
+
+  /**
+   * @brief Makes the element at the location returned by the last call of acquireWriteLocation() the newest one.
+   */
+  void publish()
+  {
+    /* the publish record is handed over together with the slot */
+    publish_records_[write_slot_].value = Record{ ++publish_sequence_number_, Clock::now() };
+    index_protocol_.publish();
+  }
+
+  /**
+   * @brief Ends the write started by the last call of acquireWriteLocation() without publishing the element. The slot
+   * is owned by the writer until then, so nothing has to be undone.
+   */
+  void abortWrite() {}
+
+  /**
+   * @return whether the location returned by the last call of acquireWriteLocation() holds the element published last,
+   * which the reader did not take over yet, so it is lost if the write is aborted after modifying it
+   */
+  bool overwritesPublishedElement() const { return false; }
+
+  /**
+   * @param is_new_location set to true if the element has not been read before
+   * @param publish_record set to the number and time of the publish operation that put the element inside
+   * @param loop_counter incremented once per iteration of a retry loop
+   * @return location of the newest element, which can be read until the next call of this function
+   */
+  template <class LoopCounter>
+  T* acquireReadLocation(bool& is_new_location, Record& publish_record, LoopCounter& loop_counter)
+  {
+    const uint8_t read_slot = index_protocol_.acquireReadSlot(is_new_location, loop_counter);
+    publish_record = publish_records_[read_slot].value;
+    return &buffer_[read_slot];
+  }
+
+  T* lastReadLocation() { return &buffer_[index_protocol_.lastReadSlot()]; }
+
+  /**
+   * @return index of the slot the element written at the moment is published in, only used for tracing
+   */
+  uint8_t writeSlot() const { return write_slot_; }
+
+  /**
+   * @return sequence number the element written at the moment is published with, only used for tracing
+   */
+  uint64_t writeSequenceNumber() const { return publish_sequence_number_ + 1; }
+
+  /**
+   * @return index of the slot read last, only used for tracing
+   */
+  uint8_t readSlot() const { return index_protocol_.lastReadSlot(); }
+
+  bool hasNewData() const { return index_protocol_.hasNewData(); }
+
+  /**
+   * @brief Repairs the state of the writer after it stopped at an arbitrary point, see
+   * WaitFreeIndexProtocol::recoverWriteSlot(). The element it may have written partially is restored from the one
+   * published last, so a new writer that only modifies parts of it never publishes a torn element.
+   * @param is_reader_stopped function returning true if the reader is not running at the moment
+   */
+  template <class Predicate>
+  void recoverWriter(Predicate&& is_reader_stopped)
+  {
+    write_slot_ = index_protocol_.recoverWriteSlot(is_reader_stopped);
+    buffer_[write_slot_] = buffer_[index_protocol_.publishedSlot()];
+  }
+
+  /**
+   * @brief Repairs the state of the reader after it stopped at an arbitrary point, see
+   * WaitFreeIndexProtocol::recoverReadSlot().
+   * @param is_writer_stopped function returning true if the writer is not running at the moment
+   */
+  template <class Predicate>
+  void recoverReader(Predicate&& is_writer_stopped)
+  {
+    index_protocol_.recoverReadSlot(is_writer_stopped);
+  }
+
+private:
+  static const uint8_t BUFFER_SIZE = IndexProtocol::SLOT_COUNT;
+
+  Slots<T, typename Traits::Layout, BUFFER_SIZE> buffer_;
+  /* publish record of the element in each slot, owned by the same thread as the slot */
+  detail::Slot<Record, typename Traits::Layout> publish_records_[BUFFER_SIZE] = {};
+  IndexProtocol index_protocol_;
+
+  /* only accessed by the writer */
+  alignas(Traits::Layout::ALIGNMENT) uint8_t write_slot_ = 0;
+  uint64_t publish_sequence_number_ = 0;
+};
+
+/**
+ * Stores the elements in two slots allocated on the heap, one of them held by the reader. The writer always writes the
+ * slot not held by the reader. If the reader did not take over the element published last, this is the slot of that
+ * element, so while it is overwritten no new element is available and the reader keeps the one it holds. The state
+ * word contains the slot published last, the slot held by the reader, whether the writer is writing and whether an
+ * element has been published since the last read. The writer sets the writing flag by a single atomic or and clears it
+ * by the store publishing the slot, so it never waits. The reader takes over the slot published last by a
+ * compare-and-swap, which it repeats at most once before it keeps its slot.
+ */
+template <class T, class Traits>
+class DoubleBufferStorage
+{
+  using Ordering = typename Traits::MemoryOrdering;
+  using SlotArray = detail::SlotArray<T, typename Traits::Layout, 2>;
+  using Clock = typename Traits::PublishTimestamps::template Implementation<Traits>;
+
+public:
+  using Record = detail::PublishRecord<typename Clock::Timestamp>;
+
+  template <class Constructor>
+  explicit DoubleBufferStorage(Constructor&& construct_element) : buffer_(std::make_unique<SlotArray>(construct_element))
+  {
+    state_.store(0, std::memory_order_relaxed);
+  }
+
+  template <class SetupFunction>
+  void setup(SetupFunction&& element_setup_function)
+  {
+    for (uint8_t slot = 0; slot < SLOT_COUNT; slot++)
+    {
+      element_setup_function((*buffer_)[slot]);
+    }
+  }
+
+  template <class LoopCounter>
+  T* acquireWriteLocation(LoopCounter&)
+  {
+    /* the reader does not change the slot it holds while the writing flag is set */
+    const uint8_t state = state_.fetch_or(WRITING_BIT, Ordering::HANDOVER);
+    write_slot_ = 1 - readSlotOf(state);
+    overwrites_published_element_ = (state & FRESH_BIT) != 0 && (state & LATEST_MASK) == write_slot_;
+    return &(*buffer_)[write_slot_];
+  }
+
+  void publish()
+  {
+    publish_records_[write_slot_].value = Record{ ++publish_sequence_number_, Clock::now() };
+    /* only the writer modifies the state while the writing flag is set, so the slot held by the reader is known */
+    state_.store(FRESH_BIT | (uint8_t(1 - write_slot_) << READ_SHIFT) | write_slot_, Ordering::HANDOVER_STORE);
+  }
+
+  /* clears the writing flag only, so an element published before stays available if it was not modified */
+  void abortWrite() { state_.fetch_and(uint8_t(~WRITING_BIT), Ordering::HANDOVER); }
+
+  bool overwritesPublishedElement() const { return overwrites_published_element_; }
+
+  template <class LoopCounter>
+  T* acquireReadLocation(bool& is_new_location, Record& publish_record, LoopCounter& loop_counter)
+  {
+    is_new_location = false;
+    uint8_t state = state_.load(Ordering::POLL);
+    for (int attempt = 0; attempt < 2 && isAvailable(state); attempt++)
+    {
+      loop_counter.increment();
+      const uint8_t latest_slot = state & LATEST_MASK;
+      if (state_.compare_exchange_strong(state, uint8_t((latest_slot << READ_SHIFT) | latest_slot), Ordering::HANDOVER, Ordering::POLL))
+      {
+        read_slot_ = latest_slot;
+        is_new_location = true;
+        break;
+      }
+    }
+    publish_record = publish_records_[read_slot_].value;
+    return &(*buffer_)[read_slot_];
+  }
+
+  T* lastReadLocation() { return &(*buffer_)[read_slot_]; }
+
+  uint8_t writeSlot() const { return write_slot_; }
+
+  uint64_t writeSequenceNumber() const { return publish_sequence_number_ + 1; }
+
+  uint8_t readSlot() const { return read_slot_; }
+
+  bool hasNewData() const { return isAvailable(state_.load(Ordering::POLL)); }
+
+private:
+  static constexpr uint8_t SLOT_COUNT = 2;
+
+  /* layout of the state word: slot published last, slot held by the reader, writing flag and fresh flag */
+  static constexpr uint8_t LATEST_MASK = 0x1;
+  static constexpr unsigned READ_SHIFT = 1;
+  static constexpr uint8_t WRITING_BIT = 0x4;
+  static constexpr uint8_t FRESH_BIT = 0x8;
+
+  static uint8_t readSlotOf(uint8_t state) { return (state >> READ_SHIFT) & 0x1; }
+  /* a new element is available, unless it is overwritten at the moment */
+  static bool isAvailable(uint8_t state) { return (state & (FRESH_BIT | WRITING_BIT)) == FRESH_BIT; }
+
+  std::unique_ptr<SlotArray> buffer_;
+  /* publish record of the element in each slot, owned by the same thread as the slot */
+  detail::Slot<Record, typename Traits::Layout> publish_records_[SLOT_COUNT] = {};
+  /* shared by both threads */
+  alignas(Traits::Layout::ALIGNMENT) std::atomic<uint8_t> state_;
+
+  /* only accessed by the writer */
+  alignas(Traits::Layout::ALIGNMENT) uint8_t write_slot_ = 1;
+  bool overwrites_published_element_ = false;
+  uint64_t publish_sequence_number_ = 0;
+
+  /* only accessed by the reader */
+  alignas(Traits::Layout::ALIGNMENT) uint8_t read_slot_ = 0;
+};
+
+/**
+ * Copy of an element shared by a seqlock, which is stored in atomic words, so reading them while the writer modifies
+ * them is no data race and only results in a copy that is discarded. The words are stored with release and loaded with
+ * acquire ordering, which orders them after the odd version stored by the writer and before the version checked by the
+ * reader afterwards. In contrast to fences this is understood by ThreadSanitizer and costs nothing on x86.
+ */
+template <class T>
+class AtomicWordsPayload
+{
+public:
+  explicit AtomicWordsPayload(const T& value)
+  {
+    for (std::atomic<uint64_t>& word : words_)
+    {
+      word.store(0, std::memory_order_relaxed);
+    }
+    store(value);
+  }
+
+  void store(const T& value)
+  {
+    uint64_t words[WORD_COUNT] = {};
+    memcpy(words, &value, sizeof(T));
+    for (size_t i = 0; i < WORD_COUNT; i++)
+    {
+      words_[i].store(words[i], std::memory_order_release);
+    }
+  }
+
+  void load(T& value) const
+  {
+    uint64_t words[WORD_COUNT];
+    for (size_t i = 0; i < WORD_COUNT; i++)
+    {
+      words[i] = words_[i].load(std::memory_order_acquire);
+    }
+    memcpy(&value, words, sizeof(T));
+  }
+
+private:
+  static constexpr size_t WORD_COUNT = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+  std::atomic<uint64_t> words_[WORD_COUNT];
+};
+
+/**
+ * Copy of an element shared by a seqlock, which is stored in a single lock-free std::atomic<T> with the same orderings
+ * as the AtomicWordsPayload.
+ */
+template <class T>
+class AtomicValuePayload
+{
+public:
+  explicit AtomicValuePayload(const T& value) : value_(value) {}
+
+  void store(const T& value) { value_.store(value, std::memory_order_release); }
+
+  void load(T& value) const { value = value_.load(std::memory_order_acquire); }
+
+private:
+  std::atomic<T> value_;
+};
+
+/**
+ * Stores the newest elements in SLOT_COUNT shared copies protected by a seqlock each. The writer and the reader work on
+ * private copies, which are transferred to or from a shared copy when an element is published or read. The writer
+ * fills the shared copies in turn and marks each one by a version, which is odd while it is modified and even
+ * afterwards, before it announces the copy as the newest one. Thus it never waits for the reader. The reader never
+ * writes shared state, but copies the newest shared copy optimistically and retries if its version changed meanwhile.
+ * With two shared copies this only happens if the writer published twice during the copy. The version of a shared copy
+ * is twice the sequence number of the element it contains, so the sequence number read always matches the element.
+ * @tparam Payload stores a shared copy in atomic variables, either AtomicWordsPayload or AtomicValuePayload
+ * @tparam SLOT_COUNT number of shared copies
+ */
+template <class T, class Traits, class Payload, uint8_t SLOT_COUNT>
+class SeqlockStorage
+{
+  static_assert(std::is_trivially_copyable<T>::value, "The seqlock can only be used for trivially copyable types");
+  static_assert(SLOT_COUNT == 1 || SLOT_COUNT == 2, "The seqlock supports one or two shared copies");
+
+  using Ordering = typename Traits::MemoryOrdering;
+  using PrivateCopy = detail::SlotArray<T, typename Traits::Layout, 1>;
+  using Clock = typename Traits::PublishTimestamps::template Implementation<Traits>;
+  using Timestamp = typename Clock::Timestamp;
+
+  struct SharedCopy
+  {
+    explicit SharedCopy(const T& value) : payload(value)
+    {
+      version.store(0, std::memory_order_relaxed);
+      if constexpr (Clock::ENABLED)
+      {
+        publish_time.store(Timestamp(), std::memory_order_relaxed);
+      }
+    }
+
+    std::atomic<uint64_t> version;
+    Payload payload;
+    /* only accessed if publish timestamps are recorded, protected by the version like the payload */
+    std::atomic<Timestamp> publish_time;
+  };
+
+public:
+  using Record = detail::PublishRecord<Timestamp>;
+
+  /**
+   * @param construct_element constructs the private copies, the shared copies are initialized from the one of the writer
+   */
+  template <class Constructor>
+  explicit SeqlockStorage(Constructor&& construct_element)
+    : write_copy_(construct_element)
+    , read_copy_(construct_element)
+    , shared_copies_([this](void* location) { new (location) SharedCopy(write_copy_[0]); })
+  {
+    latest_.store(0, std::memory_order_relaxed);
+  }
+
+  template <class SetupFunction>
+  void setup(SetupFunction&& element_setup_function)
+  {
+    element_setup_function(read_copy_[0]);
+    element_setup_function(write_copy_[0]);
+    for (uint8_t slot = 0; slot < SLOT_COUNT; slot++)
+    {
+      shared_copies_[slot].payload.store(write_copy_[0]);
+    }
+  }
+
+  template <class LoopCounter>
+  T* acquireWriteLocation(LoopCounter&)
+  {
+    return &write_copy_[0];
+  }
+
+  void publish()
+  {
+    const Timestamp publish_time = Clock::now();
+    write_slot_ = (write_slot_ + 1) % SLOT_COUNT;
+    sequence_number_++;
+    SharedCopy& shared_copy = shared_copies_[write_slot_];
+    /* the payload orders the odd version before the modification of the shared copy, while the store of the even
+     * version orders the modification before it */
+    shared_copy.version.store(2 * sequence_number_ - 1, std::memory_order_relaxed);
+    shared_copy.payload.store(write_copy_[0]);
+    if constexpr (Clock::ENABLED)
+    {
+      shared_copy.publish_time.store(publish_time, std::memory_order_release);
+    }
+    shared_copy.version.store(2 * sequence_number_, std::memory_order_release);
+    latest_.store(sequence_number_ << SEQUENCE_SHIFT | write_slot_, Ordering::HANDOVER_STORE);
+  }
+
+  /* the writer only modified its private copy */
+  void abortWrite() {}
+
+  bool overwritesPublishedElement() const { return false; }
+
+  template <class LoopCounter>
+  T* acquireReadLocation(bool& is_new_location, Record& publish_record, LoopCounter& loop_counter)
+  {
+    uint64_t latest = latest_.load(Ordering::HANDOVER_LOAD);
+    is_new_location = false;
+    /* while the shared copy following the one read last is written, the one read last is still the newest complete one.
+     * The writer stores the even version of a copy before it announces it in latest_, so the reader may have read a copy
+     * newer than latest_ already, which is why the sequence numbers are compared by their order */
+    while ((latest >> SEQUENCE_SHIFT) > read_sequence_number_)
+    {
+      loop_counter.increment();
+      const SharedCopy& shared_copy = shared_copies_[latest & SLOT_MASK];
+      const uint64_t version = shared_copy.version.load(Ordering::HANDOVER_LOAD);
+      if ((version & 1) == 0 && version / 2 > read_sequence_number_)
+      {
+        /* the payload orders the loads of the shared copy before the second load of the version */
+        shared_copy.payload.load(read_copy_[0]);
+        Timestamp publish_time{};
+        if constexpr (Clock::ENABLED)
+        {
+          publish_time = shared_copy.publish_time.load(std::memory_order_acquire);
+        }
+        if (shared_copy.version.load(std::memory_order_relaxed) == version)
+        {
+          read_sequence_number_ = version / 2;
+          read_publish_time_ = publish_time;
+          read_slot_ = latest & SLOT_MASK;
+          is_new_location = true;
+          break;
+        }
+      }
+      latest = latest_.load(Ordering::HANDOVER_LOAD);
+    }
+    publish_record = Record{ read_sequence_number_, read_publish_time_ };
+    return &read_copy_[0];
+  }
+
+  T* lastReadLocation() { return &read_copy_[0]; }
+
+  /**
+   * @return index of the shared copy the element written at the moment is published in
+   */
+  uint8_t writeSlot() const { return (write_slot_ + 1) % SLOT_COUNT; }
+
+  uint64_t writeSequenceNumber() const { return sequence_number_ + 1; }
+
+  /**
+   * @return index of the shared copy the element read last was copied from
+   */
+  uint8_t readSlot() const { return read_slot_; }
+
+  bool hasNewData() const { return (latest_.load(Ordering::POLL) >> SEQUENCE_SHIFT) > read_sequence_number_; }
+
+private:
+  /* layout of latest_: index of the shared copy published last and its sequence number */
+  static constexpr uint64_t SLOT_MASK = 0x1;
+  static constexpr unsigned SEQUENCE_SHIFT = 1;
+
+  /* only accessed by the writer, declared first as the shared copies are initialized from it */
+  PrivateCopy write_copy_;
+  alignas(Traits::Layout::ALIGNMENT) uint64_t sequence_number_ = 0;
+  uint8_t write_slot_ = 0;
+
+  /* only accessed by the reader */
+  PrivateCopy read_copy_;
+  alignas(Traits::Layout::ALIGNMENT) uint64_t read_sequence_number_ = 0;
+  Timestamp read_publish_time_{};
+  uint8_t read_slot_ = 0;
+
+  /* shared by both threads */
+  alignas(detail::ALIGNMENT_OF<typename Traits::Layout, std::atomic<uint64_t>>) std::atomic<uint64_t> latest_;
+  detail::SlotArray<SharedCopy, typename Traits::Layout, SLOT_COUNT> shared_copies_;
+};
+
+template <class T, bool = std::is_trivially_copyable<T>::value>
+struct IsAlwaysLockFree : std::integral_constant<bool, std::atomic<T>::is_always_lock_free>
+{
+};
+
+template <class T>
+struct IsAlwaysLockFree<T, false> : std::false_type
+{
+};
+}  // namespace detail
+
+/**
+ * Selects the triple buffer, which stores three elements and hands them over between the writer and the reader
+ * according to the IndexProtocol. Works for any type and accesses the elements in place.
+ */
+struct TripleBufferStrategy
+{
+  template <class T, class Traits>
+  using Implementation = detail::TripleBufferStorage<T, Traits>;
+};
+
+/**
+ * Selects the triple buffer like the TripleBufferStrategy, but its slots are three elements in memory provided by the
+ * user, e.g. buffers a driver fills by DMA or memory backed by huge pages, which are given to the constructor of the
+ * CircularLifoBuffer. The buffer only assigns them to the writer and the reader, so they are handed over without
+ * copying.
+ */
+struct ExternalSlotsStrategy
+{
+  template <class T, class Traits>
+  using Implementation = detail::TripleBufferStorage<T, Traits, detail::ExternalSlotArray>;
+};
+
+/**
+ * Selects the double buffer, which stores two elements on the heap instead of three inside the buffer object. This
+ * saves a third of the memory for very large types at the cost of the reader keeping the element it holds while the
+ * writer overwrites the newest element, which happens if the reader did not take it over before the next write
+ * started.
+ */
+struct DoubleBufferStrategy
+{
+  template <class T, class Traits>
+  using Implementation = detail::DoubleBufferStorage<T, Traits>;
+};
+
+/**
+ * Selects a seqlock with two shared copies, which are written in turn. The writer never waits, while the reader only
+ * retries if the writer published twice while it copied the newest element. Requires a trivially copyable type.
+ */
+struct SeqlockStrategy
+{
+  template <class T, class Traits>
+  using Implementation = detail::SeqlockStorage<T, Traits, detail::AtomicWordsPayload<T>, 2>;
+};
+
+/**
+ * Selects a seqlock whose single shared copy is a lock-free std::atomic<T>, so the writer and the reader transfer the
+ * element with a single atomic operation and a copy can never be torn. Requires a type for which std::atomic<T> is
+ * always lock-free.
+ */
+struct AtomicValueStrategy
+{
+  template <class T, class Traits>
+  using Implementation = detail::SeqlockStorage<T, Traits, detail::AtomicValuePayload<T>, 1>;
+};
+
+/**
+ * Selects the strategy depending on the type: the AtomicValueStrategy if std::atomic<T> is always lock-free, the
+ * SeqlockStrategy for other trivially copyable types up to CIRCULAR_LIFO_BUFFER_SEQLOCK_MAX_SIZE bytes and the
+ * TripleBufferStrategy otherwise.
+ */
+struct AutomaticStrategy
+{
+  template <class T, class Traits>
+  using Implementation = typename std::conditional_t<
+      detail::IsAlwaysLockFree<T>::value, AtomicValueStrategy,
+      std::conditional_t<std::is_trivially_copyable<T>::value && sizeof(T) <= CIRCULAR_LIFO_BUFFER_SEQLOCK_MAX_SIZE, SeqlockStrategy,
+                         TripleBufferStrategy>>::template Implementation<T, Traits>;
+};
+}  // namespace circular_lifo_buffer
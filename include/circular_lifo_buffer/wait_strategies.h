@@ -0,0 +1,185 @@
+//--------------------------------------------------------------------------------------------------------------------------------
+// Copyright 2024 Felix Biemüller, Technische Universität Darmstadt
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation
+// files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED  TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR  PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE
+//--------------------------------------------------------------------------------------------------------------------------------
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+#include "circular_lifo_buffer/layouts.h"
+
+namespace circular_lifo_buffer
+{
+namespace detail
+{
+/**
+ * Waits by polling the buffer. The reader yields its time slice first and sleeps for short periods if no new data
+ * arrives, so it does not occupy a whole core. The writer does not take part in the waiting at all.
+ */
+template <class Traits>
+class PollingWaitStrategy
+{
+public:
+  /**
+   * @brief Called by the writer after new data has been published.
+   */
+  void notify() {}
+
+  /**
+   * @brief Blocks the reader until has_new_data() returns true or the deadline is reached.
+   * @return the last result of has_new_data()
+   */
+  template <class Predicate, class Clock, class Duration>
+  bool waitUntil(Predicate has_new_data, const std::chrono::time_point<Clock, Duration>& deadline)
+  {
+    for (int iteration = 0; !has_new_data(); iteration++)
+    {
+      const auto now = Clock::now();
+      if (now >= deadline)
+      {
+        return false;
+      }
+      if (iteration < YIELD_ITERATIONS)
+      {
+        std::this_thread::yield();
+      }
+      else
+      {
+        std::this_thread::sleep_for(std::min<std::chrono::nanoseconds>(std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - now), SLEEP_DURATION));
+      }
+    }
+    return true;
+  }
+
+private:
+  static constexpr int YIELD_ITERATIONS = 100;
+  static constexpr std::chrono::microseconds SLEEP_DURATION{ 50 };
+};
+
+#ifdef __linux__
+/**
+ * Waits by parking the reader in the kernel using a futex on a counter of the publish operations. The writer
+ * increments the counter after each publish and only issues the wake system call if the reader announced that it is
+ * parked.
+ */
+template <class Traits>
+class FutexWaitStrategy
+{
+public:
+  FutexWaitStrategy()
+  {
+    publish_count_.store(0, std::memory_order_relaxed);
+    reader_parked_.store(0, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Called by the writer after new data has been published.
+   */
+  void notify()
+  {
+    /* Both operations have to be sequentially consistent, as together with the store of reader_parked_ and the load of
+     * publish_count_ in waitUntil() either the writer observes the reader being parked or the reader observes the
+     * incremented counter.
+     */
+    publish_count_.fetch_add(1, std::memory_order_seq_cst);
+    if (reader_parked_.load(std::memory_order_seq_cst) != 0)
+    {
+      syscall(SYS_futex, reinterpret_cast<uint32_t*>(&publish_count_), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+    }
+  }
+
+  /**
+   * @brief Blocks the reader until has_new_data() returns true or the deadline is reached.
+   * @return the last result of has_new_data()
+   */
+  template <class Predicate, class Clock, class Duration>
+  bool waitUntil(Predicate has_new_data, const std::chrono::time_point<Clock, Duration>& deadline)
+  {
+    while (!has_new_data())
+    {
+      const auto now = Clock::now();
+      if (now >= deadline)
+      {
+        return false;
+      }
+      /* the counter has to be loaded before checking for new data once more, so that a publish in between either
+       * is observed by has_new_data() or lets the futex return immediately as the counter does not match anymore
+       */
+      const uint32_t publish_count = publish_count_.load(std::memory_order_seq_cst);
+      reader_parked_.store(1, std::memory_order_seq_cst);
+      if (!has_new_data())
+      {
+        const auto remaining = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - now);
+        struct timespec timeout;
+        timeout.tv_sec = remaining.count() / 1000000000;
+        timeout.tv_nsec = remaining.count() % 1000000000;
+        const bool has_infinite_timeout = deadline == std::chrono::time_point<Clock, Duration>::max();
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&publish_count_), FUTEX_WAIT_PRIVATE, publish_count, has_infinite_timeout ? nullptr : &timeout,
+                nullptr, 0);
+      }
+      reader_parked_.store(0, std::memory_order_relaxed);
+    }
+    return true;
+  }
+
+private:
+  static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t) && std::atomic<uint32_t>::is_always_lock_free,
+                "The futex requires a lock-free atomic 32 bit integer");
+
+  static constexpr size_t ALIGNMENT = ALIGNMENT_OF<typename Traits::Layout, std::atomic<uint32_t>>;
+
+  /* written by the writer and used as futex by the reader */
+  alignas(ALIGNMENT) std::atomic<uint32_t> publish_count_;
+  /* written by the reader */
+  alignas(ALIGNMENT) std::atomic<uint32_t> reader_parked_;
+};
+#endif
+}  // namespace detail
+
+/**
+ * Selects waiting by polling. The reader yields and sleeps for short periods while waiting for new data and the
+ * writer does not pay anything for it.
+ */
+struct PollingWait
+{
+  template <class Traits>
+  using Implementation = detail::PollingWaitStrategy<Traits>;
+};
+
+#ifdef __linux__
+/**
+ * Selects waiting by a futex. The reader is parked in the kernel while waiting for new data and woken up by the writer,
+ * when it publishes new data. The writer pays an additional atomic increment for each publish and the system call
+ * only if the reader is parked.
+ */
+struct FutexWait
+{
+  template <class Traits>
+  using Implementation = detail::FutexWaitStrategy<Traits>;
+};
+#endif
+}  // namespace circular_lifo_buffer
@@ -0,0 +1,134 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "circular_lifo_buffer/broadcast_lifo_buffer.h"
+
+namespace circular_lifo_buffer
+{
+namespace test
+{
+struct BroadcastAcquireReleaseTraits : DefaultBufferTraits
+{
+  using MemoryOrdering = AcquireReleaseOrdering;
+  using Layout = CacheLineIsolatedLayout;
+};
+
+template <class Traits>
+class BroadcastBuffer : public ::testing::Test
+{
+};
+using BroadcastTraitsTypes = ::testing::Types<DefaultBufferTraits, BroadcastAcquireReleaseTraits>;
+TYPED_TEST_SUITE(BroadcastBuffer, BroadcastTraitsTypes);
+
+TYPED_TEST(BroadcastBuffer, IndependentReaders)
+{
+  BroadcastLifoBuffer<int, 3, TypeParam> buffer;
+  auto& first_reader = buffer.getReader(0);
+  auto& second_reader = buffer.getReader(1);
+  auto& third_reader = buffer.getReader(2);
+  int ret = 7;
+
+  /* no new data should be there after initialization */
+  EXPECT_FALSE(first_reader.hasNewData()) << "Indicates new data after initialization";
+  EXPECT_FALSE(first_reader.popIfNew(ret)) << "Indicates new data after initialization when using popIfNew";
+  EXPECT_EQ(ret, 7) << "Sets return value even if no new data available";
+
+  buffer.push(1);
+  EXPECT_TRUE(first_reader.hasNewData()) << "First reader indicates no new data after pushing";
+  EXPECT_TRUE(second_reader.hasNewData()) << "Second reader indicates no new data after pushing";
+
+  EXPECT_TRUE(first_reader.popIfNew(ret)) << "First reader indicates no new data when using popIfNew";
+  EXPECT_EQ(ret, 1) << "First reader extracts wrong value";
+  EXPECT_FALSE(first_reader.hasNewData()) << "First reader still indicates new data after extraction";
+  EXPECT_TRUE(second_reader.hasNewData()) << "Extraction of the first reader consumed the data of the second reader";
+
+  /* each reader holds a different slot, which must not be overwritten by the writer */
+  buffer.push(2);
+  EXPECT_TRUE(second_reader.popIfNew(ret)) << "Second reader indicates no new data when using popIfNew";
+  EXPECT_EQ(ret, 2) << "Second reader extracts wrong value";
+  buffer.push(3);
+  EXPECT_TRUE(third_reader.popIfNew(ret)) << "Third reader indicates no new data when using popIfNew";
+  EXPECT_EQ(ret, 3) << "Third reader extracts wrong value";
+  for (int value = 4; value < 10; value++)
+  {
+    buffer.push(value);
+  }
+  EXPECT_EQ(*first_reader.getLastSetReadAccessPtr(), 1) << "Slot held by the first reader was overwritten";
+  EXPECT_EQ(*second_reader.getLastSetReadAccessPtr(), 2) << "Slot held by the second reader was overwritten";
+  EXPECT_EQ(*third_reader.getLastSetReadAccessPtr(), 3) << "Slot held by the third reader was overwritten";
+
+  for (auto* reader : { &first_reader, &second_reader, &third_reader })
+  {
+    EXPECT_TRUE(reader->pop(ret)) << "Indicates no new data when using pop";
+    EXPECT_EQ(ret, 9) << "Extracts wrong value";
+    EXPECT_FALSE(reader->pop(ret)) << "Indicates new data after extraction when using pop";
+    EXPECT_EQ(ret, 9) << "Extracts wrong value after extraction";
+  }
+}
+
+/* Element spanning multiple words, so a read of an element that is modified at the same time is detected */
+struct BroadcastElement
+{
+  static const int WORD_COUNT = 16;
+  long words[WORD_COUNT];
+};
+
+TYPED_TEST(BroadcastBuffer, MultiThreadedTest)
+{
+  const size_t nr_of_readers = 3;
+  const long nr_of_values = 100000;
+  BroadcastLifoBuffer<BroadcastElement, nr_of_readers, TypeParam> buffer;
+  buffer.setupBufferElements([](BroadcastElement& element) {
+    for (long& word : element.words)
+    {
+      word = 0;
+    }
+  });
+
+  std::vector<std::thread> readers;
+  for (size_t reader_id = 0; reader_id < nr_of_readers; reader_id++)
+  {
+    readers.emplace_back([&buffer, reader_id, nr_of_values]() {
+      auto& reader = buffer.getReader(reader_id);
+      long last_value = 0;
+      auto start_time = std::chrono::steady_clock::now();
+      while (last_value < nr_of_values && std::chrono::steady_clock::now() - start_time < std::chrono::seconds(10))
+      {
+        bool has_new_data;
+        const BroadcastElement* const read_ptr = reader.getNewReadAccessPtr(has_new_data);
+        if (!has_new_data)
+        {
+          std::this_thread::yield();
+          continue;
+        }
+        const long value = read_ptr->words[0];
+        for (const long& word : read_ptr->words)
+        {
+          ASSERT_EQ(word, value) << "Element was modified while it was read by reader " << reader_id;
+        }
+        ASSERT_GT(value, last_value) << "Element read was not newer than the one read before by reader " << reader_id;
+        last_value = value;
+      }
+      EXPECT_EQ(last_value, nr_of_values) << "The last element written was not read by reader " << reader_id;
+    });
+  }
+
+  for (long value = 1; value <= nr_of_values; value++)
+  {
+    BroadcastElement* const write_ptr = buffer.getWriteAccessPtr();
+    for (long& word : write_ptr->words)
+    {
+      word = value;
+    }
+    buffer.indicateWriteDone();
+  }
+  for (std::thread& reader : readers)
+  {
+    reader.join();
+  }
+}
+}  // namespace test
+}  // namespace circular_lifo_buffer
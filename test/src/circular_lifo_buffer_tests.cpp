@@ -1,6 +1,11 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <set>
+#include <stdexcept>
+#include <sys/mman.h>
 #include <unistd.h>
 #include <thread>
 
@@ -10,9 +15,182 @@ namespace circular_lifo_buffer
 {
 namespace test
 {
-TEST(BasicBuffer, SingleInsertAndExtract)
+struct TripleBufferTraits : DefaultBufferTraits
 {
-  CircularLifoBuffer<int> basic_buffer;
+  using Strategy = TripleBufferStrategy;
+};
+
+struct WaitFreeTraits : TripleBufferTraits
+{
+  using IndexProtocol = WaitFreeProtocol;
+};
+
+struct CacheLineIsolatedTraits : TripleBufferTraits
+{
+  using Layout = CacheLineIsolatedLayout;
+};
+
+struct WaitFreeCacheLineIsolatedTraits : WaitFreeTraits
+{
+  using Layout = CacheLineIsolatedLayout;
+};
+
+struct AcquireReleaseTraits : TripleBufferTraits
+{
+  using MemoryOrdering = AcquireReleaseOrdering;
+};
+
+struct WaitFreeAcquireReleaseTraits : WaitFreeTraits
+{
+  using MemoryOrdering = AcquireReleaseOrdering;
+};
+
+struct FutexWaitTraits : TripleBufferTraits
+{
+  using WaitStrategy = FutexWait;
+};
+
+struct WaitFreeFutexWaitTraits : WaitFreeAcquireReleaseTraits
+{
+  using WaitStrategy = FutexWait;
+};
+
+struct DoubleBufferTraits : DefaultBufferTraits
+{
+  using Strategy = DoubleBufferStrategy;
+};
+
+struct DoubleBufferAcquireReleaseTraits : DoubleBufferTraits
+{
+  using MemoryOrdering = AcquireReleaseOrdering;
+  using Layout = CacheLineIsolatedLayout;
+  using WaitStrategy = FutexWait;
+};
+
+struct SeqlockTraits : DefaultBufferTraits
+{
+  using Strategy = SeqlockStrategy;
+};
+
+struct SeqlockAcquireReleaseTraits : SeqlockTraits
+{
+  using MemoryOrdering = AcquireReleaseOrdering;
+  using Layout = CacheLineIsolatedLayout;
+};
+
+struct AtomicValueTraits : DefaultBufferTraits
+{
+  using Strategy = AtomicValueStrategy;
+};
+
+struct AtomicValueFutexWaitTraits : AtomicValueTraits
+{
+  using MemoryOrdering = AcquireReleaseOrdering;
+  using WaitStrategy = FutexWait;
+};
+
+struct ExternalSlotsTraits : DefaultBufferTraits
+{
+  using Strategy = ExternalSlotsStrategy;
+};
+
+struct ExternalSlotsWaitFreeTraits : ExternalSlotsTraits
+{
+  using IndexProtocol = WaitFreeProtocol;
+  using MemoryOrdering = AcquireReleaseOrdering;
+};
+
+struct CapacityPreservingTraits : DefaultBufferTraits
+{
+  using Assignment = CapacityPreservingAssignment;
+};
+
+struct CapacityPreservingDoubleBufferTraits : DoubleBufferTraits
+{
+  using Assignment = CapacityPreservingAssignment;
+};
+
+struct InstrumentedTraits : TripleBufferTraits
+{
+  using Instrumentation = HistogramInstrumentation;
+};
+
+struct InstrumentedSeqlockTraits : SeqlockTraits
+{
+  using Instrumentation = HistogramInstrumentation;
+};
+
+struct TimestampTraits : TripleBufferTraits
+{
+  using PublishTimestamps = SteadyClockPublishTimestamps;
+};
+
+struct TimestampDoubleBufferTraits : DoubleBufferTraits
+{
+  using PublishTimestamps = SteadyClockPublishTimestamps;
+};
+
+struct TimestampSeqlockTraits : SeqlockAcquireReleaseTraits
+{
+  using PublishTimestamps = SteadyClockPublishTimestamps;
+};
+
+struct TimestampAtomicValueTraits : AtomicValueTraits
+{
+  using PublishTimestamps = SteadyClockPublishTimestamps;
+};
+
+/* all tests are run for each configuration of the buffer, the seqlock strategies only for trivially copyable types */
+using TraitsTypes = ::testing::Types<DefaultBufferTraits, TripleBufferTraits, WaitFreeTraits, CacheLineIsolatedTraits, WaitFreeCacheLineIsolatedTraits,
+                                     AcquireReleaseTraits, WaitFreeAcquireReleaseTraits, FutexWaitTraits, WaitFreeFutexWaitTraits, DoubleBufferTraits,
+                                     DoubleBufferAcquireReleaseTraits>;
+using TriviallyCopyableTraitsTypes =
+    ::testing::Types<DefaultBufferTraits, TripleBufferTraits, WaitFreeTraits, CacheLineIsolatedTraits, WaitFreeCacheLineIsolatedTraits, AcquireReleaseTraits,
+                     WaitFreeAcquireReleaseTraits, FutexWaitTraits, WaitFreeFutexWaitTraits, DoubleBufferTraits, DoubleBufferAcquireReleaseTraits,
+                     SeqlockTraits, SeqlockAcquireReleaseTraits>;
+using BufferTypes =
+    ::testing::Types<CircularLifoBuffer<int>, CircularLifoBuffer<int, TripleBufferTraits>, CircularLifoBuffer<int, WaitFreeTraits>,
+                     CircularLifoBuffer<int, CacheLineIsolatedTraits>, CircularLifoBuffer<int, WaitFreeCacheLineIsolatedTraits>,
+                     CircularLifoBuffer<int, AcquireReleaseTraits>, CircularLifoBuffer<int, WaitFreeAcquireReleaseTraits>, CircularLifoBuffer<int, FutexWaitTraits>,
+                     CircularLifoBuffer<int, WaitFreeFutexWaitTraits>, CircularLifoBuffer<int, DoubleBufferTraits>,
+                     CircularLifoBuffer<int, DoubleBufferAcquireReleaseTraits>, CircularLifoBuffer<int, SeqlockTraits>, CircularLifoBuffer<int, SeqlockAcquireReleaseTraits>,
+                     CircularLifoBuffer<int, AtomicValueTraits>, CircularLifoBuffer<int, AtomicValueFutexWaitTraits>>;
+
+template <class Buffer>
+class BasicBuffer : public ::testing::Test
+{
+};
+TYPED_TEST_SUITE(BasicBuffer, BufferTypes);
+
+template <class Buffer>
+class AdvancedBuffer : public ::testing::Test
+{
+};
+TYPED_TEST_SUITE(AdvancedBuffer, BufferTypes);
+
+template <class Traits>
+class MemoryOrdering : public ::testing::Test
+{
+};
+TYPED_TEST_SUITE(MemoryOrdering, TriviallyCopyableTraitsTypes);
+
+template <class Traits>
+class ElementTransfer : public ::testing::Test
+{
+};
+TYPED_TEST_SUITE(ElementTransfer, TraitsTypes);
+
+template <class Traits>
+class BlockingRead : public ::testing::Test
+{
+};
+using BlockingTraitsTypes = ::testing::Types<DefaultBufferTraits, TripleBufferTraits, WaitFreeTraits, FutexWaitTraits, WaitFreeFutexWaitTraits,
+                                             DoubleBufferTraits, DoubleBufferAcquireReleaseTraits, SeqlockTraits, AtomicValueTraits, AtomicValueFutexWaitTraits>;
+TYPED_TEST_SUITE(BlockingRead, BlockingTraitsTypes);
+
+TYPED_TEST(BasicBuffer, SingleInsertAndExtract)
+{
+  TypeParam basic_buffer;
   bool has_new_data;
   int input_value = 4;
 
@@ -49,9 +227,9 @@ TEST(BasicBuffer, SingleInsertAndExtract)
   EXPECT_EQ(has_new_data, false) << "Indicates new data after extraction when using TryPop";
 }
 
-TEST(BasicBuffer, MultipleInsertAndExtract)
+TYPED_TEST(BasicBuffer, MultipleInsertAndExtract)
 {
-  CircularLifoBuffer<int> basic_buffer;
+  TypeParam basic_buffer;
   bool has_new_data;
 
   int input_values[] = { 1, 2, 3, 4, 5, 6, 7, 8, 9 };
@@ -81,9 +259,9 @@ TEST(BasicBuffer, MultipleInsertAndExtract)
   }
 }
 
-TEST(BasicBuffer, InitializeBuffer)
+TYPED_TEST(BasicBuffer, InitializeBuffer)
 {
-  CircularLifoBuffer<int> basic_buffer;
+  TypeParam basic_buffer;
 
   int zero = 0;
   basic_buffer.push(zero);
@@ -100,9 +278,9 @@ TEST(BasicBuffer, InitializeBuffer)
   EXPECT_EQ(result, 7) << "Buffer entries were not initialized correctly";
 }
 
-TEST(AdvancedBuffer, MultipleInsertAndExtract)
+TYPED_TEST(AdvancedBuffer, MultipleInsertAndExtract)
 {
-  CircularLifoBuffer<int> advanced_buffer;
+  TypeParam advanced_buffer;
   bool has_new_data;
 
   std::vector<int> input_values = { 9, 8, 7, 6, 5, 4, 3, 2, 1 };
@@ -139,6 +317,215 @@ TEST(AdvancedBuffer, MultipleInsertAndExtract)
   }
 }
 
+/* Element counting how often it gets constructed, copied and moved */
+struct TrackedElement
+{
+  static int constructions;
+  static int copies;
+  static int moves;
+
+  static void resetCounters()
+  {
+    constructions = 0;
+    copies = 0;
+    moves = 0;
+  }
+
+  TrackedElement() = default;
+  TrackedElement(int first, int second) : value(first + second) { constructions++; }
+  TrackedElement(const TrackedElement& other) : value(other.value) { copies++; }
+  TrackedElement(TrackedElement&& other) noexcept : value(other.value) { moves++; }
+  TrackedElement& operator=(const TrackedElement& other)
+  {
+    value = other.value;
+    copies++;
+    return *this;
+  }
+  TrackedElement& operator=(TrackedElement&& other) noexcept
+  {
+    value = other.value;
+    moves++;
+    return *this;
+  }
+
+  int value = 0;
+};
+int TrackedElement::constructions = 0;
+int TrackedElement::copies = 0;
+int TrackedElement::moves = 0;
+
+TYPED_TEST(ElementTransfer, PushCopyMoveAndEmplace)
+{
+  CircularLifoBuffer<TrackedElement, TypeParam> buffer;
+  TrackedElement result;
+
+  TrackedElement::resetCounters();
+  const TrackedElement const_element(1, 2);
+  buffer.push(const_element);
+  EXPECT_EQ(TrackedElement::copies, 1) << "Pushing a const element does not copy it exactly once";
+  EXPECT_EQ(TrackedElement::moves, 0) << "Pushing a const element moves it";
+
+  TrackedElement::resetCounters();
+  buffer.push(TrackedElement(3, 4));
+  EXPECT_EQ(TrackedElement::copies, 0) << "Pushing a temporary copies it";
+  EXPECT_EQ(TrackedElement::moves, 1) << "Pushing a temporary does not move it exactly once";
+  buffer.popIfNew(result);
+  EXPECT_EQ(result.value, 7) << "Extracts wrong value after pushing a temporary";
+
+  TrackedElement::resetCounters();
+  buffer.emplace(5, 6);
+  EXPECT_EQ(TrackedElement::constructions, 1) << "Emplacing does not construct the element exactly once";
+  EXPECT_EQ(TrackedElement::copies, 0) << "Emplacing copies the element";
+  EXPECT_EQ(TrackedElement::moves, 0) << "Emplacing moves the element";
+  EXPECT_TRUE(buffer.popIfNew(result)) << "Indicates no new data after emplacing";
+  EXPECT_EQ(result.value, 11) << "Extracts wrong value after emplacing";
+}
+
+/* element whose constructor throws on request, e.g. because a resource can not be acquired */
+struct ThrowingElement
+{
+  ThrowingElement() = default;
+  ThrowingElement(int new_value, bool fail) : value(new_value)
+  {
+    if (fail)
+    {
+      throw std::runtime_error("construction failed");
+    }
+  }
+
+  int value = 0;
+};
+
+TYPED_TEST(ElementTransfer, EmplaceWithThrowingConstructor)
+{
+  CircularLifoBuffer<ThrowingElement, TypeParam> buffer;
+  ThrowingElement result;
+  buffer.emplace(1, false);
+  buffer.popIfNew(result);
+  /* the double buffer writes the slot of this element next, as the reader holds the other one */
+  buffer.emplace(2, false);
+
+  EXPECT_THROW(buffer.emplace(3, true), std::runtime_error) << "Exception of the constructor is not passed on";
+  EXPECT_TRUE(buffer.hasNewData()) << "Element published before the failed emplace is not available anymore";
+  EXPECT_TRUE(buffer.popIfNew(result)) << "Element published before the failed emplace is not available anymore";
+  EXPECT_EQ(result.value, 2) << "Element published before the failed emplace was modified";
+
+  buffer.emplace(4, false);
+  EXPECT_TRUE(buffer.popIfNew(result)) << "Indicates no new data after emplacing again";
+  EXPECT_EQ(result.value, 4) << "Extracts wrong value after emplacing again";
+}
+
+TYPED_TEST(ElementTransfer, PushMovesContainer)
+{
+  CircularLifoBuffer<std::vector<int>, TypeParam> buffer;
+  std::vector<int> input(1000, 3);
+  const int* const input_data = input.data();
+
+  buffer.push(std::move(input));
+  bool has_new_data;
+  const std::vector<int>* read_ptr = buffer.getNewReadAccessPtr(has_new_data);
+  EXPECT_TRUE(has_new_data) << "Indicates no new data after pushing";
+  EXPECT_EQ(read_ptr->data(), input_data) << "Storage of the container was not moved into the buffer";
+  EXPECT_EQ(read_ptr->size(), 1000u) << "Extracts container of wrong size";
+
+  buffer.emplace(10, 5);
+  read_ptr = buffer.getNewReadAccessPtr(has_new_data);
+  EXPECT_EQ(*read_ptr, std::vector<int>(10, 5)) << "Extracts wrong container after emplacing";
+}
+
+TYPED_TEST(ElementTransfer, ExchangeContainer)
+{
+  CircularLifoBuffer<std::vector<int>, TypeParam> buffer;
+  std::vector<int> target(100, 0);
+  const int* const target_data = target.data();
+
+  EXPECT_FALSE(buffer.exchangeIfNew(target)) << "Indicates new data after initialization";
+  EXPECT_EQ(target.data(), target_data) << "Exchanges the target even if no new data is available";
+
+  std::vector<int> input(100, 1);
+  buffer.push(input);
+  EXPECT_TRUE(buffer.exchangeIfNew(target)) << "Indicates no new data after pushing";
+  EXPECT_EQ(target, input) << "Extracts wrong value";
+  EXPECT_NE(target.data(), target_data) << "Storage of the target was not exchanged";
+  EXPECT_FALSE(buffer.exchangeIfNew(target)) << "Indicates new data after extraction";
+  EXPECT_EQ(target, input) << "Modifies the target even if no new data is available";
+
+  /* the storage of the slots and the target is recycled, so no further allocations happen for elements of the same size */
+  std::set<const int*> storage_locations;
+  for (int i = 2; i < 20; i++)
+  {
+    std::fill(input.begin(), input.end(), i);
+    buffer.push(input);
+    EXPECT_TRUE(buffer.popSwap(target)) << "Indicates no new data after pushing " << i;
+    EXPECT_EQ(target, input) << "Extracts wrong value after pushing " << i;
+    EXPECT_FALSE(buffer.popSwap(target)) << "Indicates new data after extraction of " << i;
+    EXPECT_EQ(target, input) << "Modifies the target after extraction of " << i;
+    storage_locations.insert(target.data());
+  }
+  EXPECT_LE(storage_locations.size(), 4u) << "Storage was allocated while exchanging elements";
+}
+
+/* Element without default constructor counting the number of objects alive */
+struct LiveElement
+{
+  static int alive;
+
+  explicit LiveElement(int initial_value) : value(initial_value) { alive++; }
+  LiveElement(const LiveElement& other) : value(other.value) { alive++; }
+  LiveElement& operator=(const LiveElement& other) = default;
+  ~LiveElement() { alive--; }
+
+  int value;
+};
+int LiveElement::alive = 0;
+
+TYPED_TEST(ElementTransfer, ConstructElementsInPlace)
+{
+  LiveElement::alive = 0;
+  {
+    CircularLifoBuffer<LiveElement, TypeParam> buffer(std::in_place, 5);
+    EXPECT_GE(LiveElement::alive, 2) << "Not every element was constructed";
+    EXPECT_EQ(buffer.getNewReadAccessPtr()->value, 5) << "Elements were not constructed from the arguments";
+
+    buffer.push(LiveElement(6));
+    buffer.emplace(7);
+    EXPECT_EQ(buffer.getNewReadAccessPtr()->value, 7) << "Extracts wrong value after emplacing";
+  }
+  EXPECT_EQ(LiveElement::alive, 0) << "Elements were not destroyed together with the buffer";
+
+  int nr_of_calls = 0;
+  const auto throwing_factory = [&nr_of_calls]() {
+    if (++nr_of_calls == 2)
+    {
+      throw std::runtime_error("factory failed");
+    }
+    return LiveElement(nr_of_calls);
+  };
+  EXPECT_THROW((CircularLifoBuffer<LiveElement, TypeParam>(in_place_factory, throwing_factory)), std::runtime_error);
+  EXPECT_EQ(LiveElement::alive, 0) << "Elements constructed before the exception were not destroyed";
+}
+
+TYPED_TEST(ElementTransfer, PreallocateContainers)
+{
+  CircularLifoBuffer<std::vector<int>, TypeParam> buffer(in_place_factory, []() {
+    std::vector<int> element;
+    element.reserve(100);
+    return element;
+  });
+
+  /* writing elements up to the capacity reserved reuses the storage of the slots */
+  std::set<const int*> storage_locations;
+  for (int i = 1; i < 20; i++)
+  {
+    std::vector<int>* const write_ptr = buffer.getWriteAccessPtr();
+    write_ptr->assign(size_t(i), i);
+    storage_locations.insert(write_ptr->data());
+    buffer.indicateWriteDone();
+    EXPECT_EQ(*buffer.getNewReadAccessPtr(), std::vector<int>(size_t(i), i)) << "Extracts wrong value after writing " << i;
+  }
+  EXPECT_LE(storage_locations.size(), 3u) << "Storage was allocated while writing elements";
+}
+
 /* Beginning of helper functions for multithread test */
 
 long getTimeInMs()
@@ -147,7 +534,8 @@ long getTimeInMs()
   return duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count();
 }
 
-void insert(CircularLifoBuffer<int>* buffer, int* first_element, int element_nr, int write_delay)
+template <class Buffer>
+void insert(Buffer* buffer, int* first_element, int element_nr, int write_delay)
 {
   struct timespec sleep_time;
   sleep_time.tv_sec = 0;      // seconds
@@ -162,7 +550,8 @@ void insert(CircularLifoBuffer<int>* buffer, int* first_element, int element_nr,
   }
 }
 
-void extract(CircularLifoBuffer<int>* buffer, int* first_element, int element_nr, int* successful_reads, int read_delay, int timeout)
+template <class Buffer>
+void extract(Buffer* buffer, int* first_element, int element_nr, int* successful_reads, int read_delay, int timeout)
 {
   int counter = 0;
   int old_counter = 0;
@@ -208,6 +597,9 @@ void extract(CircularLifoBuffer<int>* buffer, int* first_element, int element_nr
       }
     }
     assert(read_value == counter);
+    EXPECT_EQ(buffer->getLastReadSequenceNumber(), uint64_t(counter + 1)) << "Wrong sequence number of element " << read_value;
+    EXPECT_EQ(buffer->getNrOfSkippedElements(), uint64_t(counter - old_counter - (*successful_reads == 1 ? 0 : 1)))
+        << "Wrong number of skipped elements before element " << read_value;
     if (counter == element_nr - 1)
     {
       EXPECT_EQ(read_value, first_element[element_nr - 1]) << "The last read element has an incorrect value";
@@ -220,7 +612,41 @@ void extract(CircularLifoBuffer<int>* buffer, int* first_element, int element_nr
 
 /* Ending  of helper functions for multithread test */
 
-TEST(AdvancedBuffer, MultiThreadedTest)
+TYPED_TEST(AdvancedBuffer, SequenceNumbers)
+{
+  TypeParam advanced_buffer;
+  bool has_new_data;
+  uint64_t sequence_number = 7;
+
+  advanced_buffer.getNewReadAccessPtr(has_new_data, sequence_number);
+  EXPECT_FALSE(has_new_data) << "Indicates new data after initialization";
+  EXPECT_EQ(sequence_number, 0u) << "Sequence number set before any element was extracted";
+
+  advanced_buffer.push(1);
+  const int* read_ptr = advanced_buffer.getNewReadAccessPtr(has_new_data, sequence_number);
+  EXPECT_TRUE(has_new_data) << "Indicates no new data after pushing";
+  EXPECT_EQ(*read_ptr, 1) << "Extracts wrong value";
+  EXPECT_EQ(sequence_number, 1u) << "Wrong sequence number of the first element";
+  EXPECT_EQ(advanced_buffer.getNrOfSkippedElements(), 0u) << "Indicates skipped elements although all were extracted";
+
+  for (int value = 2; value <= 5; value++)
+  {
+    advanced_buffer.push(value);
+  }
+  int ret;
+  EXPECT_TRUE(advanced_buffer.popIfNew(ret)) << "Indicates no new data after pushing";
+  EXPECT_EQ(ret, 5) << "Extracts wrong value";
+  EXPECT_EQ(advanced_buffer.getLastReadSequenceNumber(), 5u) << "Wrong sequence number after skipping elements";
+  EXPECT_EQ(advanced_buffer.getNrOfSkippedElements(), 3u) << "Wrong number of skipped elements";
+
+  /* extracting the same element again does not change the numbers */
+  advanced_buffer.getNewReadAccessPtr(has_new_data, sequence_number);
+  EXPECT_FALSE(has_new_data) << "Indicates new data after extraction";
+  EXPECT_EQ(sequence_number, 5u) << "Sequence number changed without new element";
+  EXPECT_EQ(advanced_buffer.getNrOfSkippedElements(), 3u) << "Number of skipped elements changed without new element";
+}
+
+TYPED_TEST(AdvancedBuffer, MultiThreadedTest)
 {
   int nr_of_values = 100000;
   int* input_values = new int[nr_of_values];
@@ -229,25 +655,573 @@ TEST(AdvancedBuffer, MultiThreadedTest)
   {
     input_values[i] = i;
   }
-  double avg_success_rate = 0;
   int test_cycles = 20;
   for (int i = 0; i < test_cycles; i++)
   {
-    CircularLifoBuffer<int> advanced_buffer;
+    TypeParam advanced_buffer;
     int successful_reads = 0;
 
-    std::thread writer(insert, &advanced_buffer, input_values, nr_of_values, 0);
+    std::thread writer(insert<TypeParam>, &advanced_buffer, input_values, nr_of_values, 0);
 
-    std::thread reader(extract, &advanced_buffer, input_values, nr_of_values, &successful_reads, 0, 10000);
+    std::thread reader(extract<TypeParam>, &advanced_buffer, input_values, nr_of_values, &successful_reads, 0, 10000);
 
     writer.join();
     reader.join();
-    double success_rate = successful_reads * 1.0 / nr_of_values * 100;
-    avg_success_rate += success_rate;
   }
-  avg_success_rate = avg_success_rate / test_cycles;
-  std::cout << "[          ] [ INFO ] "
-            << "Successfully extracted an average of " << avg_success_rate << "% of the values.\n";
+  /* the freshness of the data extracted is measured by the Freshness benchmark */
+}
+
+/* the sequence numbers of the seqlock based strategies are compared with the copies, which may be published before
+ * they are announced as the newest ones */
+template <class Traits>
+class SequenceNumbers : public ::testing::Test
+{
+};
+using SequenceNumbersTraitsTypes = ::testing::Types<DefaultBufferTraits, TripleBufferTraits, WaitFreeTraits, DoubleBufferTraits, SeqlockTraits,
+                                                   SeqlockAcquireReleaseTraits, AtomicValueTraits>;
+TYPED_TEST_SUITE(SequenceNumbers, SequenceNumbersTraitsTypes);
+
+TYPED_TEST(SequenceNumbers, NeverDecreaseUnderConcurrentWriter)
+{
+  CircularLifoBuffer<long, TypeParam> buffer;
+  const long nr_of_values = 200000;
+  std::thread writer([&buffer]() {
+    for (long value = 1; value <= nr_of_values; value++)
+    {
+      buffer.push(value);
+    }
+  });
+
+  uint64_t last_sequence_number = 0;
+  long nr_of_new_reads = 0;
+  const long start_time = getTimeInMs();
+  while (last_sequence_number < uint64_t(nr_of_values) && getTimeInMs() - start_time < 10000)
+  {
+    bool has_new_data;
+    uint64_t sequence_number;
+    const long value = *buffer.getNewReadAccessPtr(has_new_data, sequence_number);
+    ASSERT_GE(buffer.getLastReadSequenceNumber(), last_sequence_number) << "Sequence number decreased";
+    if (has_new_data)
+    {
+      ASSERT_GT(sequence_number, last_sequence_number) << "Element indicated as new was read before";
+      ASSERT_EQ(uint64_t(value), sequence_number) << "Sequence number does not match the element";
+      ASSERT_LT(buffer.getNrOfSkippedElements(), uint64_t(nr_of_values)) << "Number of skipped elements wrapped around";
+      nr_of_new_reads++;
+    }
+    last_sequence_number = sequence_number;
+  }
+  writer.join();
+  EXPECT_EQ(last_sequence_number, uint64_t(nr_of_values)) << "The last element written was not read";
+  EXPECT_LE(nr_of_new_reads, nr_of_values) << "More new elements read than written";
+}
+
+/* Element spanning multiple words, which are written one after another, so a read that is not ordered after the
+ * complete write is detected by a mismatch of the words. When built with -DSANITIZE_THREAD=ON, ThreadSanitizer
+ * additionally reports every access to the elements that is not ordered by the buffer according to the C++ memory
+ * model, independent of whether the hardware would have reordered it.
+ */
+struct MultiWordElement
+{
+  static const int WORD_COUNT = 16;
+  long words[WORD_COUNT];
+};
+
+TYPED_TEST(MemoryOrdering, PayloadHandover)
+{
+  CircularLifoBuffer<MultiWordElement, TypeParam> buffer;
+  buffer.setupBufferElements([](MultiWordElement& element) {
+    for (long& word : element.words)
+    {
+      word = 0;
+    }
+  });
+  const long nr_of_values = 200000;
+
+  std::thread writer([&]() {
+    for (long value = 1; value <= nr_of_values; value++)
+    {
+      MultiWordElement* const write_ptr = buffer.getWriteAccessPtr();
+      for (long& word : write_ptr->words)
+      {
+        word = value;
+      }
+      buffer.indicateWriteDone();
+    }
+  });
+
+  long last_value = 0;
+  long start_time = getTimeInMs();
+  while (last_value < nr_of_values && getTimeInMs() - start_time < 10000)
+  {
+    bool has_new_data;
+    const MultiWordElement* const read_ptr = buffer.getNewReadAccessPtr(has_new_data);
+    if (!has_new_data)
+    {
+      std::this_thread::yield();
+      continue;
+    }
+    const long value = read_ptr->words[0];
+    for (const long& word : read_ptr->words)
+    {
+      ASSERT_EQ(word, value) << "Element was modified while it was read";
+    }
+    ASSERT_GT(value, last_value) << "Element read was not newer than the one read before";
+    last_value = value;
+  }
+  writer.join();
+  EXPECT_EQ(last_value, nr_of_values) << "The last element written was not read";
+}
+
+TYPED_TEST(BlockingRead, WaitTimesOut)
+{
+  CircularLifoBuffer<int, TypeParam> buffer;
+  const auto timeout = std::chrono::milliseconds(20);
+
+  auto start_time = std::chrono::steady_clock::now();
+  EXPECT_FALSE(buffer.waitForNewDataUntil(start_time + timeout)) << "Indicates new data after initialization";
+  EXPECT_GE(std::chrono::steady_clock::now() - start_time, timeout) << "Returned before the deadline was reached";
+
+  int target = 7;
+  start_time = std::chrono::steady_clock::now();
+  EXPECT_FALSE(buffer.popWait(target, timeout)) << "Indicates new data after initialization";
+  EXPECT_GE(std::chrono::steady_clock::now() - start_time, timeout) << "Returned before the timeout expired";
+  EXPECT_EQ(target, 7) << "Sets return value even if no new data available";
+
+  buffer.push(3);
+  EXPECT_TRUE(buffer.waitForNewDataUntil(std::chrono::steady_clock::now() + timeout)) << "Indicates no new data after pushing";
+  buffer.waitForNewData();
+  EXPECT_TRUE(buffer.popWait(target, timeout)) << "Indicates no new data after pushing";
+  EXPECT_EQ(target, 3) << "Extracts wrong value";
+}
+
+TYPED_TEST(BlockingRead, WakeUpOnPush)
+{
+  CircularLifoBuffer<int, TypeParam> buffer;
+
+  std::thread reader([&]() {
+    int target = 0;
+    auto start_time = std::chrono::steady_clock::now();
+    EXPECT_TRUE(buffer.popWait(target, std::chrono::seconds(10))) << "Was not woken up by the push";
+    EXPECT_LT(std::chrono::steady_clock::now() - start_time, std::chrono::seconds(5)) << "Was not woken up by the push in time";
+    EXPECT_EQ(target, 5) << "Extracts wrong value";
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  buffer.push(5);
+  reader.join();
+}
+
+TYPED_TEST(BlockingRead, WakeUpWithoutTimeout)
+{
+  CircularLifoBuffer<int, TypeParam> buffer;
+
+  std::atomic<bool> is_first_extracted(false);
+
+  /* adding these timeouts to the current time overflows */
+  std::thread reader([&]() {
+    int target = 0;
+    EXPECT_TRUE(buffer.popWait(target, std::chrono::nanoseconds::max())) << "Returned before the push";
+    EXPECT_EQ(target, 5) << "Extracts wrong value";
+    is_first_extracted = true;
+    EXPECT_TRUE(buffer.popWait(target, std::chrono::hours::max())) << "Returned before the push";
+    EXPECT_EQ(target, 6) << "Extracts wrong value";
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  buffer.push(5);
+  while (!is_first_extracted)
+  {
+    std::this_thread::yield();
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  buffer.push(6);
+  reader.join();
+}
+
+TYPED_TEST(BlockingRead, NoLostWakeUps)
+{
+  CircularLifoBuffer<int, TypeParam> buffer;
+  const int nr_of_values = 2000;
+
+  std::thread writer([&]() {
+    for (int value = 1; value <= nr_of_values; value++)
+    {
+      buffer.push(value);
+      if (value % 10 == 0)
+      {
+        /* give the reader time to park */
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+      }
+    }
+  });
+
+  int last_value = 0;
+  while (last_value < nr_of_values)
+  {
+    int value;
+    ASSERT_TRUE(buffer.popWait(value, std::chrono::seconds(5))) << "Missed the push after extracting " << last_value;
+    ASSERT_GT(value, last_value) << "Element read was not newer than the one read before";
+    last_value = value;
+  }
+  writer.join();
+}
+
+TEST(StorageStrategy, AutomaticSelection)
+{
+  struct Pose
+  {
+    double position[3];
+    double orientation[4];
+  };
+  using AtomicValueStorage = AtomicValueStrategy::Implementation<double, DefaultBufferTraits>;
+  using SeqlockStorage = SeqlockStrategy::Implementation<Pose, DefaultBufferTraits>;
+  using TripleBufferStorage = TripleBufferStrategy::Implementation<MultiWordElement, DefaultBufferTraits>;
+
+  EXPECT_TRUE((std::is_same<AutomaticStrategy::Implementation<double, DefaultBufferTraits>, AtomicValueStorage>::value))
+      << "No atomic value selected for a lock-free type";
+  EXPECT_TRUE((std::is_same<AutomaticStrategy::Implementation<Pose, DefaultBufferTraits>, SeqlockStorage>::value))
+      << "No seqlock selected for a small trivially copyable type";
+  EXPECT_TRUE((std::is_same<AutomaticStrategy::Implementation<MultiWordElement, DefaultBufferTraits>, TripleBufferStorage>::value))
+      << "No triple buffer selected for a large type";
+  EXPECT_TRUE((std::is_same<AutomaticStrategy::Implementation<std::vector<int>, DefaultBufferTraits>,
+                            TripleBufferStrategy::Implementation<std::vector<int>, DefaultBufferTraits>>::value))
+      << "No triple buffer selected for a type that is not trivially copyable";
+}
+
+template <class Traits>
+void checkCapacityPreservingAssignment()
+{
+  CircularLifoBuffer<std::vector<int>, Traits> buffer;
+  buffer.reserveElements(100);
+  std::vector<int> target;
+  target.reserve(100);
+
+  /* after warm-up neither writing nor reading allocates as long as the elements fit into the capacity reserved */
+  for (size_t size = 1; size <= 100; size++)
+  {
+    buffer.push(std::vector<int>(size, int(size)));
+    EXPECT_TRUE(buffer.popIfNew(target)) << "Indicates no new data after pushing " << size;
+    EXPECT_EQ(target, std::vector<int>(size, int(size))) << "Extracts wrong value after pushing " << size;
+    const std::vector<int> input(101 - size, 0);
+    buffer.push(input);
+    buffer.pop(target);
+  }
+  EXPECT_EQ(buffer.getNrOfWriteAllocations(), 0u) << "Pushing elements within the capacity reserved allocated";
+  EXPECT_EQ(buffer.getNrOfReadAllocations(), 0u) << "Extracting elements within the capacity reserved allocated";
+
+  buffer.push(std::vector<int>(200, 1));
+  buffer.popIfNew(target);
+  EXPECT_EQ(buffer.getNrOfWriteAllocations(), 1u) << "Pushing an element exceeding the capacity was not counted";
+  EXPECT_EQ(buffer.getNrOfReadAllocations(), 1u) << "Extracting an element exceeding the capacity was not counted";
+
+  /* without a new element, the one read last is copied like by the other extractions */
+  std::vector<int> empty_target;
+  EXPECT_FALSE(buffer.popSwap(empty_target)) << "Indicates new data after extraction";
+  EXPECT_EQ(empty_target, std::vector<int>(200, 1)) << "Extracts wrong value by swapping";
+  EXPECT_EQ(buffer.getNrOfReadAllocations(), 2u) << "Copying the element read last by swapping was not counted";
+}
+
+TEST(ElementAssignment, CapacityPreservingAssignment)
+{
+  checkCapacityPreservingAssignment<CapacityPreservingTraits>();
+  checkCapacityPreservingAssignment<CapacityPreservingDoubleBufferTraits>();
+}
+
+TEST(ElementAssignment, MovingReplacesStorageByDefault)
+{
+  CircularLifoBuffer<std::vector<int>> buffer;
+  buffer.reserveElements(100);
+
+  std::vector<int> input(1, 1);
+  const int* const input_data = input.data();
+  buffer.push(std::move(input));
+  EXPECT_EQ(buffer.getNewReadAccessPtr()->data(), input_data) << "Storage of the element was not moved into the buffer";
+  EXPECT_EQ(buffer.getNrOfWriteAllocations(), 0u) << "Allocations are counted by the default assignment";
+}
+
+TEST(Instrumentation, HistogramBuckets)
+{
+  for (uint64_t value : { 0ull, 1ull, 15ull, 16ull, 17ull, 100ull, 1000ull, 123456789ull, (1ull << 39) + 12345 })
+  {
+    const uint64_t lower_bound = HistogramCounts::lowerBoundOf(HistogramCounts::bucketOf(value));
+    EXPECT_LE(lower_bound, value) << "Lower bound of the bucket is above the value " << value;
+    EXPECT_LE(value - lower_bound, value / HistogramCounts::SUB_BUCKET_COUNT) << "Bucket of the value " << value << " is too wide";
+    EXPECT_EQ(HistogramCounts::bucketOf(lower_bound), HistogramCounts::bucketOf(value)) << "Lower bound lies in another bucket than " << value;
+  }
+  EXPECT_EQ(HistogramCounts::bucketOf(~0ull), HistogramCounts::BUCKET_COUNT - 1) << "Large values are not counted in the last bucket";
+
+  HistogramCounts counts;
+  counts.buckets[HistogramCounts::bucketOf(3)] = 90;
+  counts.buckets[HistogramCounts::bucketOf(1000)] = 10;
+  EXPECT_EQ(counts.totalCount(), 100u);
+  EXPECT_EQ(counts.valueAtQuantile(0.5), 3u) << "Wrong median";
+  EXPECT_EQ(counts.valueAtQuantile(0.95), HistogramCounts::lowerBoundOf(HistogramCounts::bucketOf(1000))) << "Wrong 95th percentile";
+  EXPECT_EQ(counts.maxValue(), HistogramCounts::lowerBoundOf(HistogramCounts::bucketOf(1000))) << "Wrong maximum";
+}
+
+template <class Traits>
+void checkInstrumentation(uint64_t min_read_loop_iterations)
+{
+  CircularLifoBuffer<int, Traits> buffer;
+  for (int i = 0; i < 10; i++)
+  {
+    buffer.push(i);
+  }
+  int value;
+  for (int i = 0; i < 4; i++)
+  {
+    buffer.push(i);
+    buffer.pop(value);
+  }
+
+  InstrumentationSnapshot snapshot = buffer.getInstrumentationSnapshot();
+  EXPECT_EQ(snapshot.get_write_access_ptr.cycles.totalCount(), 14u) << "Not every getWriteAccessPtr() was recorded";
+  EXPECT_EQ(snapshot.indicate_write_done.cycles.totalCount(), 14u) << "Not every indicateWriteDone() was recorded";
+  EXPECT_EQ(snapshot.get_new_read_access_ptr.cycles.totalCount(), 4u) << "Not every getNewReadAccessPtr() was recorded";
+  EXPECT_EQ(snapshot.get_new_read_access_ptr.loop_iterations.totalCount(), 4u) << "Loop iterations were not recorded";
+  EXPECT_GE(snapshot.get_new_read_access_ptr.loop_iterations.valueAtQuantile(0.0), min_read_loop_iterations)
+      << "Too few loop iterations were counted";
+
+  buffer.resetInstrumentation();
+  EXPECT_EQ(buffer.getInstrumentationSnapshot().get_write_access_ptr.cycles.totalCount(), 0u) << "Histograms were not reset";
+  buffer.push(1);
+  snapshot = buffer.getInstrumentationSnapshot();
+  EXPECT_EQ(snapshot.get_write_access_ptr.cycles.totalCount(), 1u) << "Operations after a reset were not recorded";
+  EXPECT_EQ(snapshot.get_new_read_access_ptr.cycles.totalCount(), 0u) << "Operations before a reset were recorded";
+}
+
+TEST(Instrumentation, RecordsOperations)
+{
+  checkInstrumentation<InstrumentedTraits>(1);
+  checkInstrumentation<InstrumentedSeqlockTraits>(1);
+}
+
+TEST(Instrumentation, DisabledByDefault)
+{
+  EXPECT_TRUE(std::is_empty<DefaultBufferTraits::Instrumentation::Implementation<DefaultBufferTraits>>::value)
+      << "Disabled instrumentation has a state";
+  CircularLifoBuffer<int> buffer;
+  buffer.push(1);
+  EXPECT_EQ(buffer.getInstrumentationSnapshot().indicate_write_done.cycles.totalCount(), 0u) << "Disabled instrumentation recorded";
+}
+
+template <class Traits>
+void checkPublishTimestamps()
+{
+  CircularLifoBuffer<int, Traits> buffer;
+  const auto before_push = std::chrono::steady_clock::now();
+  buffer.push(1);
+  const auto after_push = std::chrono::steady_clock::now();
+  std::this_thread::sleep_for(std::chrono::milliseconds(2));
+
+  int value;
+  EXPECT_TRUE(buffer.popIfNew(value)) << "Indicates no new data after pushing";
+  EXPECT_GE(buffer.getLastReadPublishTime(), before_push) << "Publish time is before the push";
+  EXPECT_LE(buffer.getLastReadPublishTime(), after_push) << "Publish time is after the push";
+  EXPECT_GE(buffer.getVisibilityDelay(), std::chrono::milliseconds(2)) << "Visibility delay does not include the time until the read";
+  EXPECT_GE(buffer.age(), buffer.getVisibilityDelay()) << "Element is younger than when it was extracted";
+
+  /* extracting the same element again does not change its publish time */
+  const auto visibility_delay = buffer.getVisibilityDelay();
+  std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  EXPECT_FALSE(buffer.pop(value)) << "Indicates new data after extraction";
+  EXPECT_EQ(buffer.getVisibilityDelay(), visibility_delay) << "Visibility delay changed without new element";
+  EXPECT_GE(buffer.age(), visibility_delay + std::chrono::milliseconds(1)) << "Element does not age";
+
+  /* publish times of concurrently written elements increase with their sequence numbers */
+  std::thread writer([&buffer]() {
+    for (int i = 0; i < 10000; i++)
+    {
+      buffer.push(i);
+    }
+  });
+  auto last_publish_time = buffer.getLastReadPublishTime();
+  while (buffer.getLastReadSequenceNumber() < 10001)
+  {
+    if (buffer.popIfNew(value))
+    {
+      EXPECT_GE(buffer.getLastReadPublishTime(), last_publish_time) << "Publish time decreased at element " << value;
+      last_publish_time = buffer.getLastReadPublishTime();
+    }
+  }
+  writer.join();
+}
+
+TEST(PublishTimestamps, AgeAndVisibilityDelay)
+{
+  checkPublishTimestamps<TimestampTraits>();
+  checkPublishTimestamps<TimestampDoubleBufferTraits>();
+  checkPublishTimestamps<TimestampSeqlockTraits>();
+  checkPublishTimestamps<TimestampAtomicValueTraits>();
+}
+
+/* Trivially copyable element without default constructor */
+struct Coordinate
+{
+  Coordinate(int initial_x, int initial_y) : x(initial_x), y(initial_y) {}
+
+  int x;
+  int y;
+};
+
+TEST(StorageStrategy, SeqlockConstructsElementsInPlace)
+{
+  CircularLifoBuffer<Coordinate, SeqlockTraits> seqlock_buffer(std::in_place, 1, 2);
+  CircularLifoBuffer<Coordinate, AtomicValueTraits> atomic_value_buffer(in_place_factory, []() { return Coordinate(3, 4); });
+
+  EXPECT_EQ(seqlock_buffer.getNewReadAccessPtr()->y, 2) << "Seqlock elements were not constructed from the arguments";
+  EXPECT_EQ(atomic_value_buffer.getNewReadAccessPtr()->y, 4) << "Atomic value was not constructed by the factory";
+
+  seqlock_buffer.emplace(5, 6);
+  atomic_value_buffer.emplace(7, 8);
+  EXPECT_EQ(seqlock_buffer.getNewReadAccessPtr()->x, 5) << "Extracts wrong value from the seqlock after emplacing";
+  EXPECT_EQ(atomic_value_buffer.getNewReadAccessPtr()->x, 7) << "Extracts wrong atomic value after emplacing";
+}
+
+TEST(StorageStrategy, SeqlockReaderDoesNotWaitForWriter)
+{
+  CircularLifoBuffer<MultiWordElement, SeqlockTraits> buffer;
+  MultiWordElement element;
+  for (long value = 1; value <= 3; value++)
+  {
+    std::fill(std::begin(element.words), std::end(element.words), value);
+    buffer.push(element);
+  }
+  /* an element that is being written does not hide the newest complete one */
+  MultiWordElement* const write_ptr = buffer.getWriteAccessPtr();
+  std::fill(std::begin(write_ptr->words), std::end(write_ptr->words), 4);
+  uint64_t sequence_number;
+  bool has_new_data;
+  const MultiWordElement* const read_ptr = buffer.getNewReadAccessPtr(has_new_data, sequence_number);
+  EXPECT_TRUE(has_new_data) << "Indicates no new data while the next element is written";
+  EXPECT_EQ(read_ptr->words[0], 3) << "Extracts wrong value while the next element is written";
+  EXPECT_EQ(read_ptr->words[MultiWordElement::WORD_COUNT - 1], 3) << "Extracts torn element";
+  EXPECT_EQ(sequence_number, 3u) << "Wrong sequence number";
+  buffer.indicateWriteDone();
+  EXPECT_TRUE(buffer.popIfNew(element)) << "Indicates no new data after the write is done";
+  EXPECT_EQ(element.words[0], 4) << "Extracts wrong value after the write is done";
+}
+
+TEST(StorageStrategy, DoubleBufferKeepsElementWhileNewestIsOverwritten)
+{
+  struct Frame
+  {
+    char pixels[1 << 20];
+  };
+  EXPECT_LT(sizeof(CircularLifoBuffer<Frame, DoubleBufferTraits>), sizeof(Frame)) << "Elements of the double buffer are not stored on the heap";
+
+  CircularLifoBuffer<int, DoubleBufferTraits> buffer;
+  int ret = 0;
+  buffer.push(1);
+  EXPECT_TRUE(buffer.popIfNew(ret)) << "Indicates no new data after pushing";
+  EXPECT_EQ(ret, 1) << "Extracts wrong value";
+
+  /* the second element is written to the slot not held by the reader */
+  buffer.push(2);
+  /* the third element overwrites the second one, which has not been read */
+  int* const write_ptr = buffer.getWriteAccessPtr();
+  *write_ptr = 3;
+  EXPECT_FALSE(buffer.hasNewData()) << "Indicates new data while the newest element is overwritten";
+  EXPECT_FALSE(buffer.popIfNew(ret)) << "Extracts the element that is overwritten";
+  EXPECT_EQ(*buffer.getLastSetReadAccessPtr(), 1) << "Element held by the reader was modified";
+  buffer.indicateWriteDone();
+
+  uint64_t sequence_number;
+  bool has_new_data;
+  EXPECT_EQ(*buffer.getNewReadAccessPtr(has_new_data, sequence_number), 3) << "Extracts wrong value after the write is done";
+  EXPECT_TRUE(has_new_data) << "Indicates no new data after the write is done";
+  EXPECT_EQ(sequence_number, 3u) << "Wrong sequence number";
+  EXPECT_EQ(buffer.getNrOfSkippedElements(), 1u) << "Overwritten element is not counted as skipped";
+}
+
+template <class Traits>
+void testExternalSlots()
+{
+  /* three pages of an anonymous mapping stand in for buffers mapped from a driver */
+  const size_t page_size = size_t(sysconf(_SC_PAGESIZE));
+  void* const region = mmap(nullptr, 3 * page_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  ASSERT_NE(region, MAP_FAILED) << "Could not map the slots";
+  std::array<MultiWordElement*, 3> slots;
+  for (size_t i = 0; i < slots.size(); i++)
+  {
+    slots[i] = new (static_cast<char*>(region) + i * page_size) MultiWordElement();
+  }
+
+  {
+    CircularLifoBuffer<MultiWordElement, Traits> buffer(slots);
+    const long nr_of_values = 100000;
+    std::thread writer([&buffer, &slots]() {
+      for (long value = 1; value <= nr_of_values; value++)
+      {
+        MultiWordElement* const element = buffer.getWriteAccessPtr();
+        ASSERT_NE(std::find(slots.begin(), slots.end(), element), slots.end()) << "Writes outside the external slots";
+        std::fill(std::begin(element->words), std::end(element->words), value);
+        buffer.indicateWriteDone();
+      }
+    });
+    long last_value = 0;
+    while (last_value < nr_of_values)
+    {
+      bool has_new_data;
+      const MultiWordElement* const element = buffer.getNewReadAccessPtr(has_new_data);
+      if (!has_new_data)
+      {
+        continue;
+      }
+      ASSERT_NE(std::find(slots.begin(), slots.end(), element), slots.end()) << "Reads outside the external slots";
+      ASSERT_EQ(element->words[MultiWordElement::WORD_COUNT - 1], element->words[0]) << "Read a torn element";
+      ASSERT_GT(element->words[0], last_value) << "Elements are extracted in the wrong order";
+      last_value = element->words[0];
+    }
+    writer.join();
+  }
+  EXPECT_EQ(std::max({ slots[0]->words[0], slots[1]->words[0], slots[2]->words[0] }), 100000) << "Elements were not written in place";
+  munmap(region, 3 * page_size);
+}
+
+TEST(StorageStrategy, ExternalSlots)
+{
+  testExternalSlots<ExternalSlotsTraits>();
+  testExternalSlots<ExternalSlotsWaitFreeTraits>();
+
+  int elements[3] = { 1, 2, 3 };
+  using Buffer = CircularLifoBuffer<int, ExternalSlotsTraits>;
+  EXPECT_THROW(Buffer({ &elements[0], &elements[1], nullptr }), std::invalid_argument) << "Accepted a null slot";
+  EXPECT_THROW(Buffer({ &elements[0], &elements[1], &elements[0] }), std::invalid_argument) << "Accepted a slot twice";
+  EXPECT_THROW(Buffer({ &elements[0], &elements[1], reinterpret_cast<int*>(reinterpret_cast<char*>(&elements[2]) + 1) }),
+               std::invalid_argument)
+      << "Accepted an unaligned slot";
+
+  Buffer buffer({ &elements[0], &elements[1], &elements[2] });
+  buffer.push(4);
+  int ret = 0;
+  EXPECT_TRUE(buffer.popIfNew(ret)) << "Indicates no new data after pushing";
+  EXPECT_EQ(ret, 4) << "Extracts wrong value";
+  EXPECT_EQ(std::count(std::begin(elements), std::end(elements), 4), 1) << "Element was not written into one of the slots";
+}
+
+TEST(LayoutBuffer, CacheLineIsolation)
+{
+  CircularLifoBuffer<char, CacheLineIsolatedTraits> isolated_buffer;
+  const size_t cache_line_size = CacheLineIsolatedLayout::ALIGNMENT;
+
+  EXPECT_EQ(alignof(CircularLifoBuffer<char, CacheLineIsolatedTraits>) % cache_line_size, 0) << "Buffer is not aligned to a cache line";
+  EXPECT_GE(sizeof(CircularLifoBuffer<char, CacheLineIsolatedTraits>), 6 * cache_line_size) << "Members of the buffer share cache lines";
+
+  /* every slot has to start on a cache line of its own */
+  std::vector<uintptr_t> slot_addresses;
+  for (char value = 0; value < 3; value++)
+  {
+    char* const write_ptr = isolated_buffer.getWriteAccessPtr();
+    *write_ptr = value;
+    isolated_buffer.indicateWriteDone();
+    slot_addresses.push_back(reinterpret_cast<uintptr_t>(write_ptr));
+    EXPECT_EQ(slot_addresses.back() % cache_line_size, 0) << "Slot is not aligned to a cache line";
+    /* make the slot available for the writer again */
+    isolated_buffer.getNewReadAccessPtr();
+  }
+  for (size_t i = 1; i < slot_addresses.size(); i++)
+  {
+    EXPECT_NE(slot_addresses[i] / cache_line_size, slot_addresses[i - 1] / cache_line_size) << "Slots share a cache line";
+  }
 }
 }  // namespace test
 }  // namespace circular_lifo_buffer
@@ -0,0 +1,150 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <chrono>
+#include <thread>
+
+#include "circular_lifo_buffer/history_lifo_buffer.h"
+
+namespace circular_lifo_buffer
+{
+namespace test
+{
+struct HistoryAcquireReleaseTraits : DefaultBufferTraits
+{
+  using MemoryOrdering = AcquireReleaseOrdering;
+  using Layout = CacheLineIsolatedLayout;
+};
+
+template <class Traits>
+class HistoryBuffer : public ::testing::Test
+{
+};
+using HistoryTraitsTypes = ::testing::Types<DefaultBufferTraits, HistoryAcquireReleaseTraits>;
+TYPED_TEST_SUITE(HistoryBuffer, HistoryTraitsTypes);
+
+TYPED_TEST(HistoryBuffer, SingleThreadedTest)
+{
+  HistoryLifoBuffer<int, 4, TypeParam> buffer;
+  std::array<const int*, 4> history;
+  size_t nr_of_new_elements;
+  int ret = 7;
+
+  /* no new data should be there after initialization */
+  EXPECT_FALSE(buffer.hasNewData()) << "Indicates new data after initialization";
+  EXPECT_FALSE(buffer.popIfNew(ret)) << "Indicates new data after initialization when using popIfNew";
+  EXPECT_EQ(ret, 7) << "Sets return value even if no new data available";
+  EXPECT_EQ(buffer.getHistory(history, nr_of_new_elements), 0u) << "History is not empty after initialization";
+  EXPECT_EQ(nr_of_new_elements, 0u) << "Indicates new elements after initialization";
+
+  buffer.push(1);
+  buffer.push(2);
+  EXPECT_TRUE(buffer.hasNewData()) << "Indicates no new data after pushing";
+  ASSERT_EQ(buffer.getHistory(history, nr_of_new_elements), 2u) << "History does not contain all elements pushed";
+  EXPECT_EQ(nr_of_new_elements, 2u) << "Wrong number of new elements";
+  EXPECT_EQ(*history[0], 2) << "Newest element is not the first one of the history";
+  EXPECT_EQ(*history[1], 1) << "Oldest element is not the last one of the history";
+  EXPECT_FALSE(buffer.hasNewData()) << "Indicates new data after extraction";
+
+  /* the history of the last extraction has to stay untouched while the writer continues */
+  for (int value = 3; value < 10; value++)
+  {
+    buffer.push(value);
+  }
+  EXPECT_EQ(*history[0], 2) << "Element held by the reader was overwritten";
+  EXPECT_EQ(*history[1], 1) << "Element held by the reader was overwritten";
+
+  ASSERT_EQ(buffer.getHistory(history, nr_of_new_elements), 4u) << "History is not limited to its depth";
+  EXPECT_EQ(nr_of_new_elements, 4u) << "Number of new elements is not limited to the history depth";
+  for (int i = 0; i < 4; i++)
+  {
+    EXPECT_EQ(*history[i], 9 - i) << "Wrong element at position " << i << " of the history";
+  }
+
+  buffer.push(10);
+  EXPECT_TRUE(buffer.pop(ret)) << "Indicates no new data when using pop";
+  EXPECT_EQ(ret, 10) << "Extracts wrong value";
+  EXPECT_FALSE(buffer.pop(ret)) << "Indicates new data after extraction when using pop";
+  ASSERT_EQ(buffer.getHistory(history, nr_of_new_elements), 4u) << "History got lost by extraction";
+  EXPECT_EQ(nr_of_new_elements, 0u) << "Indicates new elements after extraction";
+  EXPECT_EQ(*history[0], 10) << "Wrong newest element in the history";
+  EXPECT_EQ(*history[3], 7) << "Wrong oldest element in the history";
+}
+
+/* Element spanning multiple words, so a read of an element that is modified at the same time is detected */
+struct HistoryElement
+{
+  static const int WORD_COUNT = 16;
+  long words[WORD_COUNT];
+};
+
+TYPED_TEST(HistoryBuffer, MultiThreadedTest)
+{
+  const size_t history_depth = 3;
+  const long nr_of_values = 100000;
+  HistoryLifoBuffer<HistoryElement, history_depth, TypeParam> buffer;
+  buffer.setupBufferElements([](HistoryElement& element) {
+    for (long& word : element.words)
+    {
+      word = 0;
+    }
+  });
+
+  std::thread writer([&buffer, nr_of_values]() {
+    for (long value = 1; value <= nr_of_values; value++)
+    {
+      HistoryElement* const write_ptr = buffer.getWriteAccessPtr();
+      for (long& word : write_ptr->words)
+      {
+        word = value;
+      }
+      buffer.indicateWriteDone();
+      /* lets the reader interleave even if both threads share a single core */
+      if (value % 2 == 0)
+      {
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  /* as long as the reader keeps up with the history depth, it has to see every element */
+  long last_value = 0;
+  long nr_of_missed_values = 0;
+  std::array<const HistoryElement*, history_depth> history;
+  auto start_time = std::chrono::steady_clock::now();
+  while (last_value < nr_of_values && std::chrono::steady_clock::now() - start_time < std::chrono::seconds(10))
+  {
+    size_t nr_of_new_elements;
+    const size_t history_size = buffer.getHistory(history, nr_of_new_elements);
+    if (nr_of_new_elements == 0)
+    {
+      std::this_thread::yield();
+      continue;
+    }
+    for (size_t i = 0; i < history_size; i++)
+    {
+      const long value = history[i]->words[0];
+      for (const long& word : history[i]->words)
+      {
+        ASSERT_EQ(word, value) << "Element was modified while it was read";
+      }
+      ASSERT_EQ(value, history[0]->words[0] - long(i)) << "History does not consist of consecutive elements";
+    }
+    const long newest_value = history[0]->words[0];
+    if (nr_of_new_elements < history_depth)
+    {
+      ASSERT_EQ(newest_value - long(nr_of_new_elements), last_value) << "Number of new elements does not match the elements read before";
+    }
+    else
+    {
+      ASSERT_GE(newest_value - long(nr_of_new_elements), last_value) << "Number of new elements does not match the elements read before";
+      nr_of_missed_values += newest_value - long(nr_of_new_elements) - last_value;
+    }
+    last_value = newest_value;
+  }
+  writer.join();
+  EXPECT_EQ(last_value, nr_of_values) << "The last element written was not read";
+  std::cout << "[ INFO     ] values not part of any history read: " << nr_of_missed_values << std::endl;
+}
+}  // namespace test
+}  // namespace circular_lifo_buffer
@@ -0,0 +1,160 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "circular_lifo_buffer/multi_writer_lifo_buffer.h"
+
+namespace circular_lifo_buffer
+{
+namespace test
+{
+struct MultiWriterAcquireReleaseTraits : DefaultBufferTraits
+{
+  using MemoryOrdering = AcquireReleaseOrdering;
+  using Layout = CacheLineIsolatedLayout;
+};
+
+template <class Traits>
+class MultiWriterBuffer : public ::testing::Test
+{
+};
+using MultiWriterTraitsTypes = ::testing::Types<DefaultBufferTraits, MultiWriterAcquireReleaseTraits>;
+TYPED_TEST_SUITE(MultiWriterBuffer, MultiWriterTraitsTypes);
+
+TYPED_TEST(MultiWriterBuffer, SingleThreadedTest)
+{
+  MultiWriterLifoBuffer<int, 2, TypeParam> buffer;
+  int ret = 7;
+
+  /* no new data should be there after initialization */
+  EXPECT_FALSE(buffer.hasNewData()) << "Indicates new data after initialization";
+  EXPECT_FALSE(buffer.popIfNew(ret)) << "Indicates new data after initialization when using popIfNew";
+  EXPECT_EQ(ret, 7) << "Sets return value even if no new data available";
+
+  for (int value = 1; value < 10; value++)
+  {
+    buffer.push(value);
+  }
+  EXPECT_TRUE(buffer.hasNewData()) << "Indicates no new data after pushing";
+  EXPECT_TRUE(buffer.pop(ret)) << "Indicates no new data when using pop";
+  EXPECT_EQ(ret, 9) << "Extracts wrong value";
+  EXPECT_FALSE(buffer.hasNewData()) << "Indicates new data after extraction";
+  EXPECT_FALSE(buffer.pop(ret)) << "Indicates new data after extraction when using pop";
+  EXPECT_EQ(ret, 9) << "Extracts wrong value after extraction";
+
+  buffer.emplace(10);
+  EXPECT_TRUE(buffer.popIfNew(ret)) << "Indicates no new data after emplace";
+  EXPECT_EQ(ret, 10) << "Extracts wrong value after emplace";
+  EXPECT_EQ(*buffer.getLastSetReadAccessPtr(), 10) << "Last set read access pointer does not point to the extracted value";
+}
+
+TYPED_TEST(MultiWriterBuffer, LastPublishWins)
+{
+  MultiWriterLifoBuffer<int, 2, TypeParam> buffer;
+  int ret = 0;
+  std::atomic<bool> second_push_done{ false };
+
+  /* the first writer holds its lane while the second one publishes through the other lane */
+  std::thread first_writer([&buffer, &second_push_done]() {
+    buffer.write([&second_push_done](int& element) {
+      while (!second_push_done)
+      {
+        std::this_thread::yield();
+      }
+      element = 1;
+    });
+  });
+  std::thread second_writer([&buffer, &second_push_done]() {
+    /* give the first writer the chance to claim a lane first */
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    buffer.push(2);
+    second_push_done = true;
+  });
+  second_writer.join();
+  first_writer.join();
+
+  EXPECT_TRUE(buffer.popIfNew(ret)) << "Indicates no new data after both writers published";
+  EXPECT_EQ(ret, 1) << "The element published last did not win";
+  EXPECT_FALSE(buffer.hasNewData()) << "Element published earlier is indicated as new data";
+
+  buffer.push(3);
+  EXPECT_TRUE(buffer.popIfNew(ret)) << "Indicates no new data after pushing";
+  EXPECT_EQ(ret, 3) << "Extracts wrong value";
+}
+
+/* Element spanning multiple words, so a read of an element that is modified at the same time is detected */
+struct MultiWriterElement
+{
+  static const int WORD_COUNT = 16;
+  long words[WORD_COUNT];
+};
+
+TYPED_TEST(MultiWriterBuffer, MultiThreadedTest)
+{
+  /* more writers than lanes, so writers also have to wait for lanes */
+  const size_t nr_of_writers = 4;
+  const long nr_of_values = 20000;
+  MultiWriterLifoBuffer<MultiWriterElement, 3, TypeParam> buffer;
+  buffer.setupBufferElements([](MultiWriterElement& element) {
+    for (long& word : element.words)
+    {
+      word = 0;
+    }
+  });
+
+  std::atomic<size_t> nr_of_writers_done{ 0 };
+  std::vector<std::thread> writers;
+  for (size_t writer_id = 0; writer_id < nr_of_writers; writer_id++)
+  {
+    writers.emplace_back([&buffer, &nr_of_writers_done, writer_id, nr_of_values]() {
+      for (long value = 1; value <= nr_of_values; value++)
+      {
+        buffer.write([writer_id, nr_of_values, value](MultiWriterElement& element) {
+          for (long& word : element.words)
+          {
+            word = writer_id * nr_of_values + value;
+          }
+        });
+      }
+      nr_of_writers_done++;
+    });
+  }
+
+  /* elements may be dropped in favor of newer ones of other writers, but the elements of each writer have to be read
+   * in the order they were written */
+  std::vector<long> last_values(nr_of_writers, 0);
+  bool has_new_data = true;
+  while (has_new_data || nr_of_writers_done < nr_of_writers)
+  {
+    const MultiWriterElement* const read_ptr = buffer.getNewReadAccessPtr(has_new_data);
+    if (!has_new_data)
+    {
+      std::this_thread::yield();
+      continue;
+    }
+    const long word = read_ptr->words[0];
+    for (const long& other_word : read_ptr->words)
+    {
+      ASSERT_EQ(other_word, word) << "Element was modified while it was read";
+    }
+    const size_t writer_id = (word - 1) / nr_of_values;
+    const long value = (word - 1) % nr_of_values + 1;
+    ASSERT_GT(value, last_values[writer_id]) << "Element read was not newer than the one read before of writer " << writer_id;
+    last_values[writer_id] = value;
+  }
+  for (std::thread& writer : writers)
+  {
+    writer.join();
+  }
+
+  /* the element published last is the last element of one of the writers */
+  MultiWriterElement last_element;
+  buffer.pop(last_element);
+  const long last_word = last_element.words[0];
+  EXPECT_EQ((last_word - 1) % nr_of_values + 1, nr_of_values) << "The element published last was not read";
+}
+}  // namespace test
+}  // namespace circular_lifo_buffer
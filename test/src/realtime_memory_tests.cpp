@@ -0,0 +1,134 @@
+#include <gtest/gtest.h>
+
+#include <string.h>
+#include <sys/mman.h>
+#include <system_error>
+
+#include "circular_lifo_buffer/circular_lifo_buffer.h"
+#include "circular_lifo_buffer/realtime_memory.h"
+
+namespace circular_lifo_buffer
+{
+namespace test
+{
+struct RealtimeSlotsTraits : DefaultBufferTraits
+{
+  using Strategy = ExternalSlotsStrategy;
+  using IndexProtocol = WaitFreeProtocol;
+};
+
+struct LargeFrame
+{
+  static const size_t SIZE = 256 * 1024;
+  unsigned char pixels[SIZE];
+};
+
+/* writes one byte per page and returns the page faults it caused */
+uint64_t touchPages(void* address, size_t size)
+{
+  PageFaultMonitor monitor;
+  monitor.endWarmUp();
+  for (size_t offset = 0; offset < size; offset += detail::pageSize())
+  {
+    static_cast<volatile unsigned char*>(address)[offset] = 1;
+  }
+  return monitor.report().after_warm_up.total();
+}
+
+TEST(RealtimeMemory, PageFaultMonitorCountsFaults)
+{
+  const size_t size = 64 * detail::pageSize();
+  void* const region = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  ASSERT_NE(region, MAP_FAILED) << "Could not map memory";
+  PageFaultMonitor monitor;
+  EXPECT_GE(touchPages(region, size / 2), size / 2 / detail::pageSize()) << "First touches of pages are not counted";
+  EXPECT_GE(monitor.report().during_warm_up.minor, size / 2 / detail::pageSize()) << "Faults before the end of the warm-up are not reported";
+  EXPECT_EQ(monitor.report().after_warm_up.total(), 0u) << "Faults are reported after a warm-up that has not ended";
+
+  prefaultMemory(static_cast<char*>(region) + size / 2, size / 2, false);
+  EXPECT_EQ(touchPages(region, size), 0u) << "Prefaulted memory causes page faults";
+  munmap(region, size);
+}
+
+TEST(RealtimeMemory, PrefaultedOnConstruction)
+{
+  for (HugePages huge_pages : { HugePages::NONE, HugePages::TRANSPARENT })
+  {
+    RealtimeMemory memory(3 * detail::pageSize() + 1, huge_pages, false);
+    const size_t page_size = huge_pages == HugePages::NONE ? detail::pageSize() : detail::hugePageSize();
+    EXPECT_EQ(memory.size() % page_size, 0u) << "Size is not rounded up to the page size";
+    EXPECT_GE(memory.size(), 3 * detail::pageSize() + 1) << "Memory is too small";
+    EXPECT_EQ(touchPages(memory.data(), memory.size()), 0u) << "Memory causes page faults after construction";
+  }
+}
+
+TEST(RealtimeMemory, TransparentHugePagesAligned)
+{
+  RealtimeMemory memory(detail::hugePageSize() + 1, HugePages::TRANSPARENT, false);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(memory.data()) % detail::hugePageSize(), 0u) << "Memory is not aligned to a huge page";
+  EXPECT_EQ(memory.size(), 2 * detail::hugePageSize()) << "Size is not rounded up to the huge page size";
+  /* transparent huge pages are not guaranteed, e.g. if they are disabled */
+  EXPECT_LE(memory.hugePageBytes(), memory.size()) << "More huge pages reported than mapped";
+}
+
+TEST(RealtimeMemory, LockedMemory)
+{
+  try
+  {
+    RealtimeMemory memory(16 * detail::pageSize(), HugePages::NONE, true);
+    EXPECT_TRUE(memory.isLocked()) << "Memory is not reported as locked";
+    unsigned char residency[16];
+    ASSERT_EQ(mincore(memory.data(), memory.size(), residency), 0);
+    for (unsigned char page : residency)
+    {
+      EXPECT_NE(page & 1, 0) << "Locked page is not resident";
+    }
+  }
+  catch (const std::system_error& error)
+  {
+    GTEST_SKIP() << "Memory can not be locked: " << error.what();
+  }
+}
+
+TEST(RealtimeMemory, ExplicitHugePages)
+{
+  try
+  {
+    RealtimeMemory memory(1, HugePages::EXPLICIT, false);
+    EXPECT_EQ(memory.size(), detail::hugePageSize()) << "Size is not rounded up to the huge page size";
+    EXPECT_EQ(touchPages(memory.data(), memory.size()), 0u) << "Memory causes page faults after construction";
+  }
+  catch (const std::system_error& error)
+  {
+    GTEST_SKIP() << "No explicit huge pages are reserved: " << error.what();
+  }
+}
+
+TEST(RealtimeMemory, NoPageFaultsAfterWarmUp)
+{
+  RealtimeSlots<LargeFrame> slots(HugePages::TRANSPARENT, false);
+  for (LargeFrame* const slot : slots.slots())
+  {
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(slot) % CacheLineIsolatedLayout::ALIGNMENT, 0u) << "Slot is not aligned to a cache line";
+  }
+  CircularLifoBuffer<LargeFrame, RealtimeSlotsTraits> buffer(slots.slots());
+
+  PageFaultMonitor monitor;
+  unsigned long checksum = 0;
+  for (int cycle = 0; cycle < 100; cycle++)
+  {
+    if (cycle == 10)
+    {
+      monitor.endWarmUp();
+    }
+    LargeFrame* const frame = buffer.getWriteAccessPtr();
+    memset(frame->pixels, cycle, LargeFrame::SIZE);
+    buffer.indicateWriteDone();
+    checksum += buffer.getNewReadAccessPtr()->pixels[LargeFrame::SIZE - 1];
+  }
+  const PageFaultReport report = monitor.report();
+  EXPECT_EQ(report.after_warm_up.total(), 0u) << "Page faults happened after the warm-up";
+  EXPECT_EQ(checksum, 99u * 100u / 2u) << "Extracts wrong frames";
+}
+}  // namespace test
+}  // namespace circular_lifo_buffer
@@ -0,0 +1,282 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "circular_lifo_buffer/shared_memory_lifo_buffer.h"
+
+namespace circular_lifo_buffer
+{
+namespace test
+{
+struct SharedAcquireReleaseTraits : DefaultBufferTraits
+{
+  using MemoryOrdering = AcquireReleaseOrdering;
+  using Layout = CacheLineIsolatedLayout;
+};
+
+/* Element spanning several words, so a torn read is detected by a mismatch of the words */
+struct SharedElement
+{
+  static const int WORD_COUNT = 8;
+  long words[WORD_COUNT];
+};
+
+template <class Traits>
+class SharedMemoryBuffer : public ::testing::Test
+{
+protected:
+  /* the name contains the process id, so tests running in parallel do not collide */
+  const std::string name_ = "/circular_lifo_buffer_test_" + std::to_string(getpid());
+
+  void SetUp() override { SharedMemoryLifoBuffer<int>::unlink(name_); }
+  void TearDown() override { SharedMemoryLifoBuffer<int>::unlink(name_); }
+};
+using SharedTraitsTypes = ::testing::Types<DefaultBufferTraits, SharedAcquireReleaseTraits>;
+TYPED_TEST_SUITE(SharedMemoryBuffer, SharedTraitsTypes);
+
+TYPED_TEST(SharedMemoryBuffer, CreateAndAttach)
+{
+  using SharedBuffer = SharedMemoryLifoBuffer<int, TypeParam>;
+  auto writer = SharedBuffer::create(this->name_);
+  auto reader = SharedBuffer::attach(this->name_);
+  EXPECT_NE(&writer.buffer(), &reader.buffer()) << "Both sides use the same mapping";
+  EXPECT_EQ(reader.header().layout_version, SharedMemoryHeader::LAYOUT_VERSION) << "Wrong layout version";
+
+  int ret = 7;
+  EXPECT_FALSE(reader->popIfNew(ret)) << "Indicates new data after creation";
+  writer->push(1);
+  writer->push(2);
+  EXPECT_TRUE(reader->hasNewData()) << "Data pushed through another mapping is not visible";
+  EXPECT_TRUE(reader->popIfNew(ret)) << "Indicates no new data after pushing";
+  EXPECT_EQ(ret, 2) << "Extracts wrong value";
+  EXPECT_EQ(reader->getNrOfSkippedElements(), 1u) << "Wrong number of skipped elements";
+
+  int* const write_ptr = writer->getWriteAccessPtr();
+  *write_ptr = 3;
+  writer->indicateWriteDone();
+  bool has_new_data;
+  EXPECT_EQ(*reader->getNewReadAccessPtr(has_new_data), 3) << "Extracts wrong value through the pointer API";
+  EXPECT_TRUE(has_new_data) << "Indicates no new data after writing through the pointer API";
+
+  EXPECT_THROW(SharedBuffer::create(this->name_), std::system_error) << "Created an existing object twice";
+}
+
+TYPED_TEST(SharedMemoryBuffer, RejectsDifferentLayout)
+{
+  using SharedBuffer = SharedMemoryLifoBuffer<int, TypeParam>;
+  using OtherSharedBuffer = SharedMemoryLifoBuffer<SharedElement, TypeParam>;
+  EXPECT_THROW(SharedBuffer::attach(this->name_), std::system_error) << "Attached to a missing object";
+
+  auto creator = SharedBuffer::create(this->name_);
+  EXPECT_THROW(OtherSharedBuffer::attach(this->name_), std::runtime_error) << "Attached with a different element type";
+  EXPECT_THROW(OtherSharedBuffer::attach(creator.fileDescriptor()), std::runtime_error) << "Attached with a different element type";
+  /* same size and alignment, so only the type hash tells them apart */
+  EXPECT_THROW((SharedMemoryLifoBuffer<float, TypeParam>::attach(this->name_)), std::runtime_error) << "Attached with a different element type of the same size";
+  EXPECT_THROW((SharedMemoryLifoBuffer<float, TypeParam>::attach(creator.fileDescriptor())), std::runtime_error)
+      << "Attached with a different element type of the same size";
+
+  const_cast<SharedMemoryHeader&>(creator.header()).layout_version++;
+  EXPECT_THROW(SharedBuffer::attach(this->name_), std::runtime_error) << "Attached to a different layout version";
+  const_cast<SharedMemoryHeader&>(creator.header()).magic = 0;
+  EXPECT_THROW(SharedBuffer::attach(this->name_), std::runtime_error) << "Attached to an uninitialized region";
+}
+
+TYPED_TEST(SharedMemoryBuffer, AnonymousMemoryFile)
+{
+  auto writer = SharedMemoryLifoBuffer<int, TypeParam>::createAnonymous();
+  auto reader = SharedMemoryLifoBuffer<int, TypeParam>::attach(writer.fileDescriptor());
+  writer->push(5);
+  int ret = 0;
+  EXPECT_TRUE(reader->popIfNew(ret)) << "Indicates no new data after pushing";
+  EXPECT_EQ(ret, 5) << "Extracts wrong value";
+}
+
+TYPED_TEST(SharedMemoryBuffer, WriterProcess)
+{
+  const int nr_of_values = 100000;
+  auto reader = SharedMemoryLifoBuffer<SharedElement, TypeParam>::create(this->name_);
+
+  const pid_t writer_pid = fork();
+  ASSERT_GE(writer_pid, 0) << "Could not start the writer process";
+  if (writer_pid == 0)
+  {
+    auto writer = SharedMemoryLifoBuffer<SharedElement, TypeParam>::attach(this->name_);
+    for (long value = 1; value <= nr_of_values; value++)
+    {
+      SharedElement* const element = writer->getWriteAccessPtr();
+      for (long& word : element->words)
+      {
+        word = value;
+      }
+      writer->indicateWriteDone();
+    }
+    _exit(0);
+  }
+
+  long last_value = 0;
+  while (last_value < nr_of_values)
+  {
+    bool has_new_data;
+    const SharedElement* const element = reader->getNewReadAccessPtr(has_new_data);
+    if (!has_new_data)
+    {
+      continue;
+    }
+    for (long word : element->words)
+    {
+      ASSERT_EQ(word, element->words[0]) << "Read a torn element";
+    }
+    ASSERT_GT(element->words[0], last_value) << "Elements are extracted in the wrong order";
+    ASSERT_EQ(reader->getLastReadSequenceNumber(), uint64_t(element->words[0])) << "Wrong sequence number";
+    last_value = element->words[0];
+  }
+
+  int status;
+  ASSERT_EQ(waitpid(writer_pid, &status, 0), writer_pid);
+  EXPECT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0) << "Writer process failed";
+}
+TYPED_TEST(SharedMemoryBuffer, RecoverWriterThatDied)
+{
+  using SharedBuffer = SharedMemoryLifoBuffer<SharedElement, TypeParam>;
+  auto reader = SharedBuffer::create(this->name_);
+  EXPECT_EQ(reader.claimReader(), 1u) << "Wrong epoch of the first reader";
+
+  const pid_t writer_pid = fork();
+  ASSERT_GE(writer_pid, 0) << "Could not start the writer process";
+  if (writer_pid == 0)
+  {
+    auto writer = SharedBuffer::attach(this->name_);
+    writer.claimWriter();
+    writer->push(SharedElement{ { 1, 1, 1, 1, 1, 1, 1, 1 } });
+    /* dies in the middle of a write */
+    SharedElement* const element = writer->getWriteAccessPtr();
+    element->words[0] = 99;
+    element->words[1] = 99;
+    _exit(0);
+  }
+  int status;
+  ASSERT_EQ(waitpid(writer_pid, &status, 0), writer_pid);
+
+  auto writer = SharedBuffer::attach(this->name_);
+  EXPECT_EQ(writer.claimWriter(), 2u) << "Wrong epoch of the restarted writer";
+  EXPECT_EQ(reader.writerEpoch(), 2u) << "Restart of the writer is not visible to the reader";
+  auto other_writer = SharedBuffer::attach(this->name_);
+  EXPECT_THROW(other_writer.claimWriter(), std::runtime_error) << "Replaced a writer that is alive";
+  EXPECT_THROW(writer.claimReader(), std::runtime_error) << "Registered one object twice";
+
+  /* a new writer only modifying parts of the element must not publish the partial write of the dead one */
+  SharedElement* const element = writer->getWriteAccessPtr();
+  for (long word : element->words)
+  {
+    EXPECT_EQ(word, 1) << "Partial write of the dead writer is not discarded";
+  }
+  element->words[7] = 2;
+  writer->indicateWriteDone();
+
+  bool has_new_data;
+  const SharedElement* const read_element = reader->getNewReadAccessPtr(has_new_data);
+  EXPECT_TRUE(has_new_data) << "Indicates no new data after recovery";
+  EXPECT_EQ(read_element->words[0], 1) << "Read a torn element";
+  EXPECT_EQ(read_element->words[7], 2) << "Extracts wrong value";
+  EXPECT_EQ(reader->getLastReadSequenceNumber(), 2u) << "Wrong sequence number";
+}
+
+TYPED_TEST(SharedMemoryBuffer, RecoverReaderThatDied)
+{
+  using SharedBuffer = SharedMemoryLifoBuffer<int, TypeParam>;
+  auto writer = SharedBuffer::create(this->name_);
+  writer.claimWriter();
+  writer->push(1);
+
+  const pid_t reader_pid = fork();
+  ASSERT_GE(reader_pid, 0) << "Could not start the reader process";
+  if (reader_pid == 0)
+  {
+    auto reader = SharedBuffer::attach(this->name_);
+    reader.claimReader();
+    bool has_new_data;
+    reader->getNewReadAccessPtr(has_new_data);
+    _exit(has_new_data ? 0 : 1);
+  }
+  int status;
+  ASSERT_EQ(waitpid(reader_pid, &status, 0), reader_pid);
+  EXPECT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0) << "Reader process failed";
+
+  writer->push(2);
+  auto reader = SharedBuffer::attach(this->name_);
+  EXPECT_EQ(reader.claimReader(), 2u) << "Wrong epoch of the restarted reader";
+  writer->push(3);
+  int ret = 0;
+  EXPECT_TRUE(reader->popIfNew(ret)) << "Indicates no new data after recovery";
+  EXPECT_EQ(ret, 3) << "Extracts wrong value";
+  EXPECT_EQ(reader->getNrOfSkippedElements(), 1u) << "Wrong number of skipped elements";
+}
+
+TYPED_TEST(SharedMemoryBuffer, UnregistersOnDestruction)
+{
+  using SharedBuffer = SharedMemoryLifoBuffer<int, TypeParam>;
+  auto creator = SharedBuffer::create(this->name_);
+  {
+    auto writer = SharedBuffer::attach(this->name_);
+    writer.claimWriter();
+    EXPECT_EQ(creator.header().writer.pid.load(), getpid()) << "Writer is not registered";
+  }
+  EXPECT_EQ(creator.header().writer.pid.load(), 0) << "Writer is not unregistered";
+  EXPECT_EQ(creator.claimWriter(), 2u) << "Could not register again";
+}
+TYPED_TEST(SharedMemoryBuffer, SendOverSocket)
+{
+  using SharedBuffer = SharedMemoryLifoBuffer<SharedElement, TypeParam>;
+  int sockets[2];
+  ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, sockets), 0) << "Could not create the sockets";
+  auto reader = SharedBuffer::createAnonymous();
+  EXPECT_NE(fcntl(reader.fileDescriptor(), F_GET_SEALS) & F_SEAL_SHRINK, 0) << "Size of the memory file is not sealed";
+
+  const pid_t writer_pid = fork();
+  ASSERT_GE(writer_pid, 0) << "Could not start the writer process";
+  if (writer_pid == 0)
+  {
+    /* the inherited mapping is not used, only the received one */
+    auto writer = SharedBuffer::receive(sockets[1]);
+    writer->push(SharedElement{ { 7, 7, 7, 7, 7, 7, 7, 7 } });
+    _exit(0);
+  }
+  reader.send(sockets[0]);
+  int status;
+  ASSERT_EQ(waitpid(writer_pid, &status, 0), writer_pid);
+  EXPECT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0) << "Writer process failed";
+
+  SharedElement ret{};
+  EXPECT_TRUE(reader->popIfNew(ret)) << "Data pushed through the received mapping is not visible";
+  EXPECT_EQ(ret.words[7], 7) << "Extracts wrong value";
+  close(sockets[0]);
+  close(sockets[1]);
+}
+
+TYPED_TEST(SharedMemoryBuffer, ReceiveRejectsOtherType)
+{
+  int sockets[2];
+  ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, sockets), 0) << "Could not create the sockets";
+  auto sender = SharedMemoryLifoBuffer<int, TypeParam>::createAnonymous();
+  sender.send(sockets[0]);
+  EXPECT_THROW(SharedMemoryLifoBuffer<float>::receive(sockets[1]), std::runtime_error) << "Received a buffer of a different type";
+
+  const char no_file_descriptor[sizeof(detail::SharedMemoryHandOff)] = {};
+  ASSERT_EQ(write(sockets[0], no_file_descriptor, sizeof(no_file_descriptor)), ssize_t(sizeof(no_file_descriptor)));
+  EXPECT_THROW(SharedMemoryLifoBuffer<int>::receive(sockets[1]), std::runtime_error) << "Received no file descriptor";
+
+  sender.send(sockets[0]);
+  auto receiver = SharedMemoryLifoBuffer<int, TypeParam>::receive(sockets[1]);
+  sender->push(3);
+  int ret = 0;
+  EXPECT_TRUE(receiver->popIfNew(ret)) << "Indicates no new data after pushing";
+  EXPECT_EQ(ret, 3) << "Extracts wrong value";
+  close(sockets[0]);
+  close(sockets[1]);
+}
+}  // namespace test
+}  // namespace circular_lifo_buffer
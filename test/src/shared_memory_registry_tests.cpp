@@ -0,0 +1,174 @@
+#include <gtest/gtest.h>
+
+#include <string.h>
+#include <algorithm>
+#include <string>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "circular_lifo_buffer/shared_memory_registry.h"
+
+namespace circular_lifo_buffer
+{
+namespace test
+{
+struct Position
+{
+  double values[3];
+};
+
+/* same size as Position, so it is only told apart by the type hash */
+struct Velocity
+{
+  double values[3];
+};
+
+struct RegistryAcquireReleaseTraits : DefaultBufferTraits
+{
+  using MemoryOrdering = AcquireReleaseOrdering;
+};
+
+/* maps the table of the registry of the given name, e.g. to leave it in the state of a process that died */
+SharedMemoryRegistryTable* mapRegistryTable(const std::string& name)
+{
+  const int file_descriptor = shm_open(name.c_str(), O_RDWR | O_CREAT, 0600);
+  if (file_descriptor < 0 || ftruncate(file_descriptor, off_t(sizeof(SharedMemoryRegistryTable))) != 0)
+  {
+    return nullptr;
+  }
+  void* const region = mmap(nullptr, sizeof(SharedMemoryRegistryTable), PROT_READ | PROT_WRITE, MAP_SHARED, file_descriptor, 0);
+  close(file_descriptor);
+  return region == MAP_FAILED ? nullptr : static_cast<SharedMemoryRegistryTable*>(region);
+}
+
+/* id of a process that exited and was reaped, so no process has it */
+pid_t deadProcessId()
+{
+  const pid_t pid = fork();
+  if (pid == 0)
+  {
+    _exit(0);
+  }
+  int status;
+  waitpid(pid, &status, 0);
+  return pid;
+}
+
+class SharedMemoryRegistryTest : public ::testing::Test
+{
+protected:
+  /* the name contains the process id, so tests running in parallel do not collide */
+  const std::string name_ = "/circular_lifo_buffer_registry_test_" + std::to_string(getpid());
+
+  void SetUp() override { SharedMemoryRegistry::unlink(name_); }
+  void TearDown() override
+  {
+    auto registry = SharedMemoryRegistry::open(name_);
+    for (const std::string& buffer_name : registry.names())
+    {
+      registry.remove(buffer_name);
+    }
+    SharedMemoryRegistry::unlink(name_);
+  }
+};
+
+TEST_F(SharedMemoryRegistryTest, CreateAndAttachByName)
+{
+  auto writer_registry = SharedMemoryRegistry::open(name_);
+  auto writer = writer_registry.create<Position>("joint_states");
+  EXPECT_EQ(writer_registry.objectName("joint_states"), name_ + ".joint_states") << "Wrong name of the shared memory object";
+
+  /* another process opens the existing registry */
+  auto reader_registry = SharedMemoryRegistry::open(name_);
+  auto reader = reader_registry.attach<Position>("joint_states");
+  writer->push(Position{ { 1.0, 2.0, 3.0 } });
+  Position ret{};
+  EXPECT_TRUE(reader->popIfNew(ret)) << "Indicates no new data after pushing";
+  EXPECT_EQ(ret.values[2], 3.0) << "Extracts wrong value";
+}
+
+TEST_F(SharedMemoryRegistryTest, ChecksTypeAndConfiguration)
+{
+  auto registry = SharedMemoryRegistry::open(name_);
+  auto buffer = registry.create<Position>("position");
+  EXPECT_THROW(registry.attach<Velocity>("position"), std::runtime_error) << "Attached with a different type of the same size";
+  EXPECT_THROW((registry.attach<Position, RegistryAcquireReleaseTraits>("position")), std::runtime_error)
+      << "Attached with a different configuration";
+  EXPECT_THROW(registry.attach<Position>("velocity"), std::runtime_error) << "Attached to a buffer that is not registered";
+  EXPECT_THROW(registry.create<Position>("position"), std::runtime_error) << "Registered a name twice";
+  EXPECT_THROW(registry.create<Position>("a/b"), std::invalid_argument) << "Accepted a name containing a slash";
+  EXPECT_THROW(registry.create<Position>(""), std::invalid_argument) << "Accepted an empty name";
+  EXPECT_NE(SharedMemoryLifoBuffer<Position>::typeHash(), SharedMemoryLifoBuffer<Velocity>::typeHash()) << "Types have the same hash";
+}
+
+TEST_F(SharedMemoryRegistryTest, ManyBuffers)
+{
+  const int nr_of_buffers = 40;
+  auto registry = SharedMemoryRegistry::open(name_);
+  for (int i = 0; i < nr_of_buffers; i++)
+  {
+    registry.create<int>("channel_" + std::to_string(i))->push(i);
+  }
+  std::vector<std::string> names = registry.names();
+  EXPECT_EQ(names.size(), size_t(nr_of_buffers)) << "Wrong number of registered buffers";
+
+  auto other_registry = SharedMemoryRegistry::open(name_);
+  for (int i = 0; i < nr_of_buffers; i++)
+  {
+    int ret = -1;
+    EXPECT_TRUE(other_registry.attach<int>("channel_" + std::to_string(i))->pop(ret)) << "Pushed value is lost";
+    EXPECT_EQ(ret, i) << "Extracts value of a different buffer";
+  }
+
+  EXPECT_TRUE(registry.remove("channel_0")) << "Could not remove a registered buffer";
+  EXPECT_FALSE(registry.remove("channel_0")) << "Removed a buffer twice";
+  names = other_registry.names();
+  EXPECT_EQ(std::count(names.begin(), names.end(), "channel_0"), 0) << "Removed buffer is still registered";
+  EXPECT_THROW(other_registry.attach<int>("channel_0"), std::runtime_error) << "Attached to a removed buffer";
+  EXPECT_NO_THROW(registry.create<int>("channel_0")) << "Could not register a removed name again";
+}
+TEST_F(SharedMemoryRegistryTest, TakesOverInitializationOfDeadProcess)
+{
+  SharedMemoryRegistryTable* const table = mapRegistryTable(name_);
+  ASSERT_NE(table, nullptr) << "Could not map the registry";
+  table->magic.store(SharedMemoryRegistryTable::initializingBy(int32_t(deadProcessId())));
+  munmap(table, sizeof(SharedMemoryRegistryTable));
+
+  /* waits forever if the initialization is not taken over */
+  auto registry = SharedMemoryRegistry::open(name_);
+  EXPECT_NO_THROW(registry.create<Position>("position")) << "Could not register a buffer";
+}
+
+TEST_F(SharedMemoryRegistryTest, TakesOverEntriesOfDeadProcess)
+{
+  auto registry = SharedMemoryRegistry::open(name_);
+  const pid_t creator_pid = fork();
+  ASSERT_GE(creator_pid, 0) << "Could not start the creating process";
+  if (creator_pid == 0)
+  {
+    /* reserves every entry and dies after creating the shared memory object of the first one */
+    SharedMemoryRegistryTable* const table = mapRegistryTable(name_);
+    for (SharedMemoryRegistryEntry& entry : table->entries)
+    {
+      entry.state.store(SharedMemoryRegistryEntry::makeState(SharedMemoryRegistryEntry::RESERVED, 1, int32_t(getpid())));
+    }
+    strcpy(table->entries[0].name, "position");
+    table->entries[0].state.store(SharedMemoryRegistryEntry::makeState(SharedMemoryRegistryEntry::CREATING, 1, int32_t(getpid())));
+    SharedMemoryLifoBuffer<Position>::create(registry.objectName("position"));
+    _exit(0);
+  }
+  int status;
+  ASSERT_EQ(waitpid(creator_pid, &status, 0), creator_pid);
+
+  SharedMemoryLifoBuffer<Position> writer = registry.create<Position>("position");
+  EXPECT_NO_THROW(registry.create<Position>("velocity")) << "Entries reserved by a dead process are not taken over";
+  EXPECT_EQ(registry.names().size(), 2u) << "Wrong number of registered buffers";
+  writer->push(Position{ { 1.0, 2.0, 3.0 } });
+  Position ret{};
+  EXPECT_TRUE(registry.attach<Position>("position")->popIfNew(ret)) << "Attached to the object left behind";
+  EXPECT_EQ(ret.values[2], 3.0) << "Extracts wrong value";
+}
+}  // namespace test
+}  // namespace circular_lifo_buffer